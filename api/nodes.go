@@ -701,8 +701,16 @@ type HostStats struct {
 	CPU              []*HostCPUStats
 	DiskStats        []*HostDiskStats
 	DeviceStats      []*DeviceGroupStats
+	Temperatures     []*HostTemperatureStats
+	Thermal          *HostThermalStats
+	Fans             []*HostFanStats
+	Power            []*HostPowerStats
+	Voltages         []*HostVoltageStats
+	SensorWindow     *HostSensorWindowStats
 	Uptime           uint64
 	CPUTicksConsumed float64
+	SensorTimestamp  int64
+	SensorAge        time.Duration
 }
 
 type HostMemoryStats struct {
@@ -713,10 +721,12 @@ type HostMemoryStats struct {
 }
 
 type HostCPUStats struct {
-	CPU    string
-	User   float64
-	System float64
-	Idle   float64
+	CPU            string
+	User           float64
+	System         float64
+	Idle           float64
+	Throttled      bool
+	FrequencyRatio float64
 }
 
 type HostDiskStats struct {
@@ -729,6 +739,47 @@ type HostDiskStats struct {
 	InodesUsedPercent float64
 }
 
+type HostTemperatureStats struct {
+	Sensor  string
+	Celsius float64
+}
+
+type HostThermalStats struct {
+	MaxCelsius      float64
+	HeadroomCelsius float64
+}
+
+type HostFanStats struct {
+	Sensor string
+	RPM    float64
+}
+
+type HostPowerStats struct {
+	Sensor string
+	Watts  float64
+}
+
+type HostVoltageStats struct {
+	Sensor string
+	Volts  float64
+}
+
+type HostSensorWindowStats struct {
+	Start   int64
+	End     int64
+	Sensors []*HostSensorAggregateStats
+}
+
+type HostSensorAggregateStats struct {
+	Sensor  string
+	Samples int
+	Min     float64
+	Max     float64
+	Mean    float64
+	P95     float64
+	EWMA    float64
+}
+
 // DeviceGroupStats contains statistics for each device of a particular
 // device group, identified by the vendor, type and name of the device.
 type DeviceGroupStats struct {
@@ -41,11 +41,20 @@ type CpuStats struct {
 	Measured         []string
 }
 
+// PowerStats holds the power drawn by a workload, estimated from its share of
+// the host's CPU usage
+type PowerStats struct {
+	Sensor string
+	Share  float64
+	Watts  float64
+}
+
 // ResourceUsage holds information related to cpu and memory stats
 type ResourceUsage struct {
 	MemoryStats *MemoryStats
 	CpuStats    *CpuStats
 	DeviceStats []*DeviceGroupStats
+	PowerStats  *PowerStats
 }
 
 // TaskResourceUsage holds aggregated resource usage of all processes in a Task
@@ -136,6 +136,9 @@ type allocRunner struct {
 	// deviceStatsReporter is used to lookup resource usage for alloc devices
 	deviceStatsReporter cinterfaces.DeviceStatsReporter
 
+	// powerStatsReporter is used to attribute host power to alloc tasks
+	powerStatsReporter cinterfaces.PowerStatsReporter
+
 	// allocBroadcaster sends client allocation updates to all listeners
 	allocBroadcaster *cstructs.AllocBroadcaster
 
@@ -209,6 +212,7 @@ func NewAllocRunner(config *Config) (*allocRunner, error) {
 		taskStateUpdateHandlerCh: make(chan struct{}),
 		allocUpdatedCh:           make(chan *structs.Allocation, 1),
 		deviceStatsReporter:      config.DeviceStatsReporter,
+		powerStatsReporter:       config.PowerStatsReporter,
 		prevAllocWatcher:         config.PrevAllocWatcher,
 		prevAllocMigrator:        config.PrevAllocMigrator,
 		dynamicRegistry:          config.DynamicRegistry,
@@ -261,6 +265,7 @@ func (ar *allocRunner) initTaskRunners(tasks []*structs.Task) error {
 			ConsulSI:             ar.sidsClient,
 			Vault:                ar.vaultClient,
 			DeviceStatsReporter:  ar.deviceStatsReporter,
+			PowerStatsReporter:   ar.powerStatsReporter,
 			CSIManager:           ar.csiManager,
 			DeviceManager:        ar.devicemanager,
 			DriverManager:        ar.driverManager,
@@ -49,6 +49,9 @@ type Config struct {
 	// DeviceStatsReporter is used to lookup resource usage for alloc devices
 	DeviceStatsReporter interfaces.DeviceStatsReporter
 
+	// PowerStatsReporter is used to attribute host power to alloc tasks
+	PowerStatsReporter interfaces.PowerStatsReporter
+
 	// PrevAllocWatcher handles waiting on previous or preempted allocations
 	PrevAllocWatcher allocwatcher.PrevAllocWatcher
 
@@ -196,6 +196,9 @@ type TaskRunner struct {
 	// deviceStatsReporter is used to lookup resource usage for alloc devices
 	deviceStatsReporter cinterfaces.DeviceStatsReporter
 
+	// powerStatsReporter is used to attribute host power to the task
+	powerStatsReporter cinterfaces.PowerStatsReporter
+
 	// csiManager is used to manage the mounting of CSI volumes into tasks
 	csiManager csimanager.Manager
 
@@ -267,6 +270,9 @@ type Config struct {
 	// deviceStatsReporter is used to lookup resource usage for alloc devices
 	DeviceStatsReporter cinterfaces.DeviceStatsReporter
 
+	// PowerStatsReporter is used to attribute host power to the task
+	PowerStatsReporter cinterfaces.PowerStatsReporter
+
 	// CSIManager is used to manage the mounting of CSI volumes into tasks
 	CSIManager csimanager.Manager
 
@@ -329,6 +335,7 @@ func NewTaskRunner(config *Config) (*TaskRunner, error) {
 		stateDB:                config.StateDB,
 		stateUpdater:           config.StateUpdater,
 		deviceStatsReporter:    config.DeviceStatsReporter,
+		powerStatsReporter:     config.PowerStatsReporter,
 		killCtx:                killCtx,
 		killCtxCancel:          killCancel,
 		shutdownCtx:            trCtx,
@@ -1361,6 +1368,13 @@ func (tr *TaskRunner) LatestResourceUsage() *cstructs.TaskResourceUsage {
 
 // UpdateStats updates and emits the latest stats from the driver.
 func (tr *TaskRunner) UpdateStats(ru *cstructs.TaskResourceUsage) {
+	// Attribute host power as the stats are collected, rather than when they
+	// are fetched, so that it is read at the same time as the CPU usage it is
+	// attributed by.
+	if ru != nil && ru.ResourceUsage != nil && tr.powerStatsReporter != nil {
+		ru.ResourceUsage.PowerStats = tr.powerStatsReporter.LatestPowerStats(ru.ResourceUsage.CpuStats)
+	}
+
 	tr.resourceUsageLock.Lock()
 	tr.resourceUsage = ru
 	tr.resourceUsageLock.Unlock()
@@ -1426,6 +1440,13 @@ func (tr *TaskRunner) setGaugeForCPU(ru *cstructs.TaskResourceUsage) {
 	}
 }
 
+func (tr *TaskRunner) setGaugeForPower(ru *cstructs.TaskResourceUsage) {
+	metrics.SetGaugeWithLabels([]string{"client", "allocs", "power", "watts"},
+		float32(ru.ResourceUsage.PowerStats.Watts), tr.baseLabels)
+	metrics.SetGaugeWithLabels([]string{"client", "allocs", "power", "share"},
+		float32(ru.ResourceUsage.PowerStats.Share), tr.baseLabels)
+}
+
 // emitStats emits resource usage stats of tasks to remote metrics collector
 // sinks
 func (tr *TaskRunner) emitStats(ru *cstructs.TaskResourceUsage) {
@@ -1444,6 +1465,10 @@ func (tr *TaskRunner) emitStats(ru *cstructs.TaskResourceUsage) {
 	} else {
 		tr.logger.Debug("Skipping cpu stats for allocation", "reason", "CpuStats is nil")
 	}
+
+	if ru.ResourceUsage.PowerStats != nil {
+		tr.setGaugeForPower(ru)
+	}
 }
 
 // appendTaskEvent updates the task status by appending the new event.
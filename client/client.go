@@ -3,6 +3,7 @@ package client
 import (
 	"fmt"
 	"io/ioutil"
+	"math"
 	"net"
 	"net/rpc"
 	"os"
@@ -49,6 +50,7 @@ import (
 	hstats "github.com/hashicorp/nomad/helper/stats"
 	"github.com/hashicorp/nomad/helper/tlsutil"
 	"github.com/hashicorp/nomad/helper/uuid"
+	"github.com/hashicorp/nomad/lib/darwin"
 	"github.com/hashicorp/nomad/nomad/structs"
 	nconfig "github.com/hashicorp/nomad/nomad/structs/config"
 	"github.com/hashicorp/nomad/plugins/csi"
@@ -109,6 +111,10 @@ const (
 	//
 	// https://www.envoyproxy.io/docs/envoy/latest/operations/cli#cmdoption-concurrency
 	defaultConnectProxyConcurrency = "1"
+
+	// thermalHeadroomStep is the granularity of the thermal headroom
+	// attribute in °C.
+	thermalHeadroomStep = 5
 )
 
 var (
@@ -235,6 +241,16 @@ type Client struct {
 	// HostStatsCollector collects host resource usage stats
 	hostStatsCollector *stats.HostStatsCollector
 
+	// thermalAttribute is whether the thermal headroom derived from the host
+	// stats is published as a node attribute.
+	thermalAttribute bool
+
+	// thermalHeadroom is the thermal headroom attribute last published, if
+	// thermalHeadroomSet. Both are only accessed by the host stats
+	// collection goroutine.
+	thermalHeadroom    int
+	thermalHeadroomSet bool
+
 	// shutdown is true when the Client has been shutdown. Must hold
 	// shutdownLock to access.
 	shutdown bool
@@ -339,6 +355,15 @@ func NewClient(cfg *config.Config, consulCatalog consul.CatalogAPI, consulProxie
 	// Create the logger
 	logger := cfg.Logger.ResetNamedIntercept("client")
 
+	// Route errors from the native hardware sensor layer through our logger
+	darwin.SetLogger(logger.Named("smc"))
+
+	// Keep the discovered hardware sensors next to the client state so that
+	// restarts skip enumerating them again
+	if cfg.StateDir != "" {
+		darwin.SetDiscoveryCache(filepath.Join(cfg.StateDir, "sensors.json"))
+	}
+
 	// Create the client
 	c := &Client{
 		config:               cfg,
@@ -480,7 +505,32 @@ func NewClient(cfg *config.Config, consulCatalog consul.CatalogAPI, consulProxie
 	go c.heartbeatStop.watch()
 
 	// Add the stats collector
-	statsCollector := stats.NewHostStatsCollector(c.logger, c.config.AllocDir, c.devicemanager.AllStats)
+	samplerInterval := c.config.ReadDurationDefault("sensors.sampler.interval", c.config.StatsCollectionInterval)
+	samplerWindow := c.config.ReadDurationDefault("sensors.sampler.window", time.Minute)
+	sensorConfig := &stats.SensorConfig{
+		SamplerEnabled:           c.config.ReadBoolDefault("sensors.sampler.enabled", false),
+		SamplerInterval:          samplerInterval,
+		SamplerMaxInterval:       c.config.ReadDurationDefault("sensors.sampler.max_interval", samplerInterval),
+		SamplerVarianceThreshold: c.config.ReadFloatDefault("sensors.sampler.variance_threshold", 0.01),
+		SamplerRateThreshold:     c.config.ReadFloatDefault("sensors.sampler.rate_threshold", 1),
+		SamplerWorkers:           c.config.ReadIntDefault("sensors.sampler.workers", 1),
+		SamplerWindow:            samplerWindow,
+		SamplerEWMATimeConstant:  c.config.ReadDurationDefault("sensors.sampler.ewma_time_constant", samplerWindow),
+
+		CriticalCelsius:     c.config.ReadFloatDefault("sensors.thermal.critical", 100),
+		ThermalTimeConstant: c.config.ReadDurationDefault("sensors.thermal.time_constant", time.Minute),
+
+		ChangeEpsilon: c.config.ReadFloatDefault("sensors.change_epsilon", 0),
+		ChangeRefresh: c.config.ReadDurationDefault("sensors.change_refresh", 30*time.Second),
+
+		MaxStaleness: c.config.ReadDurationDefault("sensors.max_staleness", 0),
+		PowerSensor:  c.config.ReadDefault("sensors.power.sensor", ""),
+
+		Thresholds:  c.sensorThresholds(),
+		OnThreshold: c.emitSensorThresholdEvent,
+	}
+	statsCollector := stats.NewHostStatsCollector(c.logger, c.config.AllocDir, c.devicemanager.AllStats, sensorConfig)
+	c.thermalAttribute = c.config.ReadBoolDefault("sensors.thermal.attribute", false)
 	c.hostStatsCollector = statsCollector
 
 	// Add the garbage collector
@@ -792,6 +842,9 @@ func (c *Client) Shutdown() error {
 	// Wait for goroutines to stop
 	c.shutdownGroup.Wait()
 
+	// Stop reading hardware sensors once nothing collects host stats
+	c.hostStatsCollector.Shutdown()
+
 	// One final save state
 	c.saveState()
 	return c.stateDB.Close()
@@ -909,6 +962,26 @@ func (c *Client) LatestDeviceResourceStats(devices []*structs.AllocatedDeviceRes
 	return c.computeAllocatedDeviceGroupStats(devices, c.LatestHostStats().DeviceStats)
 }
 
+// LatestPowerStats estimates the power drawn by a workload with the given CPU
+// usage, or returns nil if the host's power cannot be read.
+func (c *Client) LatestPowerStats(cpu *cstructs.CpuStats) *cstructs.PowerStats {
+	if cpu == nil {
+		return nil
+	}
+
+	attribution := c.hostStatsCollector.PowerAttribution()
+	if attribution == nil {
+		return nil
+	}
+
+	share := attribution.Share(cpu.Percent)
+	return &cstructs.PowerStats{
+		Sensor: attribution.Sensor,
+		Share:  share,
+		Watts:  share * attribution.Watts,
+	}
+}
+
 func (c *Client) computeAllocatedDeviceGroupStats(devices []*structs.AllocatedDeviceResource, hostDeviceGroupStats []*device.DeviceGroupStats) []*device.DeviceGroupStats {
 	// basic optimization for the usual case
 	if len(devices) == 0 || len(hostDeviceGroupStats) == 0 {
@@ -1124,6 +1197,7 @@ func (c *Client) restoreState() error {
 			StateDB:             c.stateDB,
 			StateUpdater:        c,
 			DeviceStatsReporter: c,
+			PowerStatsReporter:  c,
 			Consul:              c.consulService,
 			ConsulSI:            c.tokensClient,
 			ConsulProxies:       c.consulProxies,
@@ -2422,6 +2496,7 @@ func (c *Client) addAlloc(alloc *structs.Allocation, migrateToken string) error
 		Vault:               c.vaultClient,
 		StateUpdater:        c,
 		DeviceStatsReporter: c,
+		PowerStatsReporter:  c,
 		PrevAllocWatcher:    prevAllocWatcher,
 		PrevAllocMigrator:   prevAllocMigrator,
 		DynamicRegistry:     c.dynamicRegistry,
@@ -2797,9 +2872,13 @@ func (c *Client) emitStats() {
 			next.Reset(c.config.StatsCollectionInterval)
 			if err != nil {
 				c.logger.Warn("error fetching host resource usage stats", "error", err)
-			} else if c.config.PublishNodeMetrics {
+			} else {
+				c.updateThermalAttribute()
+
 				// Publish Node metrics if operator has opted in
-				c.emitHostStats()
+				if c.config.PublishNodeMetrics {
+					c.emitHostStats()
+				}
 			}
 
 			c.emitClientMetrics()
@@ -2809,6 +2888,117 @@ func (c *Client) emitStats() {
 	}
 }
 
+// updateThermalAttribute sets the node's thermal headroom attribute from the
+// latest host stats when the operator has opted in. The node is only updated
+// when the step of the headroom changes, see thermalHeadroomStepFor, so that
+// it is only re-registered when the headroom changes meaningfully.
+func (c *Client) updateThermalAttribute() {
+	if !c.thermalAttribute {
+		return
+	}
+
+	thermal := c.hostStatsCollector.Stats().Thermal
+	if thermal == nil {
+		return
+	}
+
+	headroom := thermalHeadroomStepFor(thermal.HeadroomCelsius, c.thermalHeadroom, c.thermalHeadroomSet)
+	if c.thermalHeadroomSet && headroom == c.thermalHeadroom {
+		return
+	}
+	c.thermalHeadroom, c.thermalHeadroomSet = headroom, true
+
+	c.updateNodeFromFingerprint(&fingerprint.FingerprintResponse{
+		Attributes: map[string]string{
+			structs.NodeAttrThermalHeadroom: strconv.Itoa(headroom),
+		},
+	})
+}
+
+// thermalHeadroomStepFor returns the thermal headroom to publish, rounded down
+// to thermalHeadroomStep, given the step last published if any. The headroom
+// only moves off the last step once it is half a step past either of its
+// boundaries, so that a headroom hovering around a boundary does not flip the
+// attribute back and forth.
+func thermalHeadroomStepFor(headroom float64, last int, published bool) int {
+	const step = float64(thermalHeadroomStep)
+
+	if published && headroom >= float64(last)-step/2 && headroom < float64(last)+step*3/2 {
+		return last
+	}
+	return int(math.Floor(headroom/step)) * thermalHeadroomStep
+}
+
+// sensorThresholds parses the watermarks of hardware sensors from the
+// "sensors.threshold.<sensor>.high" and "sensors.threshold.<sensor>.low"
+// options. Every sensor shares the "sensors.threshold.hysteresis" option
+// unless it sets "sensors.threshold.<sensor>.hysteresis".
+func (c *Client) sensorThresholds() map[string]stats.SensorThreshold {
+	const prefix = "sensors.threshold."
+
+	hysteresis := c.config.ReadFloatDefault(prefix+"hysteresis", 1)
+	thresholds := make(map[string]stats.SensorThreshold)
+	for option := range c.config.Options {
+		if !strings.HasPrefix(option, prefix) {
+			continue
+		}
+
+		sensor, watermark := option[len(prefix):], ""
+		if i := strings.LastIndexByte(sensor, '.'); i >= 0 {
+			sensor, watermark = sensor[:i], sensor[i+1:]
+		}
+		if sensor == "" || watermark != "high" && watermark != "low" {
+			continue
+		}
+
+		value, err := c.config.ReadFloat(option)
+		if err != nil {
+			c.logger.Warn("ignoring invalid sensor threshold", "option", option, "error", err)
+			continue
+		}
+
+		threshold, ok := thresholds[sensor]
+		if !ok {
+			threshold = darwin.DisabledThreshold()
+			threshold.Hysteresis = c.config.ReadFloatDefault(prefix+sensor+".hysteresis", hysteresis)
+		}
+		if watermark == "high" {
+			threshold.High = value
+		} else {
+			threshold.Low = value
+		}
+		thresholds[sensor] = threshold
+	}
+	return thresholds
+}
+
+// emitSensorThresholdEvent surfaces a hardware sensor crossing one of its
+// watermarks as a node event.
+func (c *Client) emitSensorThresholdEvent(e *stats.SensorThresholdEvent) {
+	var msg string
+	switch {
+	case e.Level == "high":
+		msg = fmt.Sprintf("Sensor %s reached its high watermark", e.Sensor)
+	case e.Level == "low":
+		msg = fmt.Sprintf("Sensor %s reached its low watermark", e.Sensor)
+	case e.Previous == "high":
+		msg = fmt.Sprintf("Sensor %s dropped back below its high watermark", e.Sensor)
+	default:
+		msg = fmt.Sprintf("Sensor %s rose back above its low watermark", e.Sensor)
+	}
+
+	c.logger.Info("sensor crossed a threshold", "sensor", e.Sensor, "level", e.Level, "value", e.Value)
+	c.triggerNodeEvent(structs.NewNodeEvent().
+		SetSubsystem(structs.NodeEventSubsystemSensors).
+		SetMessage(msg).
+		SetTimestamp(e.Timestamp).
+		AddDetail("sensor", e.Sensor).
+		AddDetail("level", e.Level).
+		AddDetail("previous", e.Previous).
+		AddDetail("value", strconv.FormatFloat(e.Value, 'f', -1, 32)).
+		AddDetail("watermark", strconv.FormatFloat(e.Watermark, 'f', -1, 64)))
+}
+
 // setGaugeForMemoryStats proxies metrics for memory specific statistics
 func (c *Client) setGaugeForMemoryStats(nodeID string, hStats *stats.HostStats, baseLabels []metrics.Label) {
 	metrics.SetGaugeWithLabels([]string{"client", "host", "memory", "total"}, float32(hStats.Memory.Total), baseLabels)
@@ -2829,6 +3019,7 @@ func (c *Client) setGaugeForCPUStats(nodeID string, hStats *stats.HostStats, bas
 		metrics.SetGaugeWithLabels([]string{"client", "host", "cpu", "user"}, float32(cpu.User), labels)
 		metrics.SetGaugeWithLabels([]string{"client", "host", "cpu", "idle"}, float32(cpu.Idle), labels)
 		metrics.SetGaugeWithLabels([]string{"client", "host", "cpu", "system"}, float32(cpu.System), labels)
+		metrics.SetGaugeWithLabels([]string{"client", "host", "cpu", "frequency_ratio"}, float32(cpu.FrequencyRatio), labels)
 	}
 }
 
@@ -2848,6 +3039,89 @@ func (c *Client) setGaugeForDiskStats(nodeID string, hStats *stats.HostStats, ba
 	}
 }
 
+// setGaugeForTemperatureStats proxies metrics for hardware temperature sensors.
+// Only readings that changed since they were last reported are emitted.
+func (c *Client) setGaugeForTemperatureStats(nodeID string, hStats *stats.HostStats, baseLabels []metrics.Label) {
+	for _, temp := range hStats.TemperatureChanges {
+		labels := append(baseLabels, metrics.Label{
+			Name:  "sensor",
+			Value: temp.Sensor,
+		})
+
+		metrics.SetGaugeWithLabels([]string{"client", "host", "temperature"}, float32(temp.Celsius), labels)
+	}
+
+	if hStats.Thermal != nil {
+		metrics.SetGaugeWithLabels([]string{"client", "host", "thermal", "max"}, float32(hStats.Thermal.MaxCelsius), baseLabels)
+		metrics.SetGaugeWithLabels([]string{"client", "host", "thermal", "headroom"}, float32(hStats.Thermal.HeadroomCelsius), baseLabels)
+	}
+}
+
+// setGaugeForSensorStats proxies metrics for hardware fan, power and voltage
+// sensors.
+func (c *Client) setGaugeForSensorStats(nodeID string, hStats *stats.HostStats, baseLabels []metrics.Label) {
+	sensorLabels := func(sensor string) []metrics.Label {
+		return append(baseLabels, metrics.Label{
+			Name:  "sensor",
+			Value: sensor,
+		})
+	}
+
+	for _, fan := range hStats.Fans {
+		metrics.SetGaugeWithLabels([]string{"client", "host", "fan", "rpm"}, float32(fan.RPM), sensorLabels(fan.Sensor))
+	}
+	for _, power := range hStats.Power {
+		metrics.SetGaugeWithLabels([]string{"client", "host", "power"}, float32(power.Watts), sensorLabels(power.Sensor))
+	}
+	for _, voltage := range hStats.Voltages {
+		metrics.SetGaugeWithLabels([]string{"client", "host", "voltage"}, float32(voltage.Volts), sensorLabels(voltage.Sensor))
+	}
+}
+
+// setGaugeForSensorReadStats proxies metrics describing the cost of reading
+// hardware sensors. The native counters are cumulative, so they are emitted as
+// gauges; latency buckets are cumulative too and labeled with their upper
+// bound in seconds.
+func (c *Client) setGaugeForSensorReadStats(nodeID string, hStats *stats.HostStats, baseLabels []metrics.Label) {
+	s := hStats.SensorReads
+	if s == nil {
+		return
+	}
+
+	metrics.SetGaugeWithLabels([]string{"client", "host", "sensors", "calls"}, float32(s.Calls), baseLabels)
+	metrics.SetGaugeWithLabels([]string{"client", "host", "sensors", "key_not_found"}, float32(s.KeyNotFound), baseLabels)
+	metrics.SetGaugeWithLabels([]string{"client", "host", "sensors", "missing_cached"}, float32(s.MissingCached), baseLabels)
+	metrics.SetGaugeWithLabels([]string{"client", "host", "sensors", "reconnects"}, float32(s.Reconnects), baseLabels)
+	metrics.SetGaugeWithLabels([]string{"client", "host", "sensors", "decode_failures"}, float32(s.DecodeFailures), baseLabels)
+
+	setGaugeForHistogram([]string{"client", "host", "sensors", "call_latency"}, &s.CallLatency, baseLabels)
+	setGaugeForHistogram([]string{"client", "host", "sensors", "reconnect_latency"}, &s.ReconnectLatency, baseLabels)
+}
+
+// setGaugeForHistogram emits the cumulative count of every bucket of h up to
+// the last one that is in use, along with its total count and sum.
+func setGaugeForHistogram(key []string, h *darwin.Histogram, baseLabels []metrics.Label) {
+	last := -1
+	for i, n := range h.Buckets {
+		if n != 0 {
+			last = i
+		}
+	}
+
+	var count uint64
+	for i := 0; i <= last; i++ {
+		count += h.Buckets[i]
+		labels := append(baseLabels, metrics.Label{
+			Name:  "le",
+			Value: strconv.FormatFloat(darwin.BucketBound(i).Seconds(), 'g', -1, 64),
+		})
+		metrics.SetGaugeWithLabels(key, float32(count), labels)
+	}
+
+	metrics.SetGaugeWithLabels(append(key, "count"), float32(h.Count), baseLabels)
+	metrics.SetGaugeWithLabels(append(key, "sum"), float32(h.Sum.Seconds()), baseLabels)
+}
+
 // setGaugeForAllocationStats proxies metrics for allocation specific statistics
 func (c *Client) setGaugeForAllocationStats(nodeID string, baseLabels []metrics.Label) {
 	c.configLock.RLock()
@@ -2912,6 +3186,9 @@ func (c *Client) emitHostStats() {
 	c.setGaugeForUptime(hStats, labels)
 	c.setGaugeForCPUStats(nodeID, hStats, labels)
 	c.setGaugeForDiskStats(nodeID, hStats, labels)
+	c.setGaugeForTemperatureStats(nodeID, hStats, labels)
+	c.setGaugeForSensorStats(nodeID, hStats, labels)
+	c.setGaugeForSensorReadStats(nodeID, hStats, labels)
 }
 
 // emitClientMetrics emits lower volume client metrics
@@ -3,6 +3,7 @@ package client
 import (
 	"fmt"
 	"io/ioutil"
+	"math"
 	"net"
 	"os"
 	"path/filepath"
@@ -1633,6 +1634,69 @@ func TestClient_hasLocalState(t *testing.T) {
 	})
 }
 
+func TestClient_sensorThresholds(t *testing.T) {
+	t.Parallel()
+
+	c := &Client{
+		logger: testlog.HCLogger(t),
+		config: &config.Config{
+			Options: map[string]string{
+				"sensors.threshold.hysteresis":      "2",
+				"sensors.threshold.TC0P.high":       "95",
+				"sensors.threshold.TC0P.low":        "10",
+				"sensors.threshold.TG0P.high":       "100",
+				"sensors.threshold.TG0P.hysteresis": "5",
+				"sensors.threshold.F0Ac.low":        "fast",
+				"sensors.thermal.critical":          "90",
+			},
+		},
+	}
+
+	thresholds := c.sensorThresholds()
+	require.Len(t, thresholds, 2)
+
+	require.Equal(t, 95.0, thresholds["TC0P"].High)
+	require.Equal(t, 10.0, thresholds["TC0P"].Low)
+	require.Equal(t, 2.0, thresholds["TC0P"].Hysteresis)
+
+	require.Equal(t, 100.0, thresholds["TG0P"].High)
+	require.True(t, math.IsNaN(thresholds["TG0P"].Low))
+	require.Equal(t, 5.0, thresholds["TG0P"].Hysteresis)
+}
+
+func TestClient_thermalHeadroomStepFor(t *testing.T) {
+	t.Parallel()
+
+	// The first headroom is rounded down, including below zero.
+	require.Equal(t, 20, thermalHeadroomStepFor(24.9, 0, false))
+	require.Equal(t, 25, thermalHeadroomStepFor(25, 0, false))
+	require.Equal(t, -5, thermalHeadroomStepFor(-0.5, 0, false))
+
+	// A headroom hovering around a boundary keeps the step last published
+	// until it is half a step past it.
+	steps := []struct {
+		headroom float64
+		expected int
+	}{
+		{24.9, 20},
+		{25.1, 20},
+		{24.9, 20},
+		{27.4, 20},
+		{27.5, 25},
+		{24.9, 25},
+		{25.1, 25},
+		{22.6, 25},
+		{22.4, 20},
+		{10, 10},
+	}
+	last, published := 0, false
+	for _, step := range steps {
+		last = thermalHeadroomStepFor(step.headroom, last, published)
+		published = true
+		require.Equal(t, step.expected, last, "headroom %v", step.headroom)
+	}
+}
+
 func Test_verifiedTasks(t *testing.T) {
 	t.Parallel()
 	logger := testlog.HCLogger(t)
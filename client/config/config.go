@@ -410,6 +410,29 @@ func (c *Config) ReadIntDefault(id string, defaultValue int) int {
 	return val
 }
 
+// ReadFloat parses the specified option as a float.
+func (c *Config) ReadFloat(id string) (float64, error) {
+	val, ok := c.Options[id]
+	if !ok {
+		return 0, fmt.Errorf("Specified config is missing from options")
+	}
+	fval, err := strconv.ParseFloat(val, 64)
+	if err != nil {
+		return 0, fmt.Errorf("Failed to parse %s as float: %s", val, err)
+	}
+	return fval, nil
+}
+
+// ReadFloatDefault tries to parse the specified option as a float. If there is
+// an error in parsing, the default option is returned.
+func (c *Config) ReadFloatDefault(id string, defaultValue float64) float64 {
+	val, err := c.ReadFloat(id)
+	if err != nil {
+		return defaultValue
+	}
+	return val
+}
+
 // ReadDuration parses the specified option as a duration.
 func (c *Config) ReadDuration(id string) (time.Duration, error) {
 	val, ok := c.Options[id]
@@ -34,3 +34,25 @@ func TestConfigReadDefault(t *testing.T) {
 		t.Errorf("Expected %s, found %s", expected, actual)
 	}
 }
+
+func TestConfigReadFloatDefault(t *testing.T) {
+	config := Config{}
+
+	expected := 0.5
+	actual := config.ReadFloatDefault("cake", expected)
+	if actual != expected {
+		t.Errorf("Expected %v, found %v", expected, actual)
+	}
+
+	config.Options = map[string]string{"cake": "1.25"}
+	actual = config.ReadFloatDefault("cake", expected)
+	if actual != 1.25 {
+		t.Errorf("Expected 1.25, found %v", actual)
+	}
+
+	config.Options = map[string]string{"cake": "chocolate"}
+	actual = config.ReadFloatDefault("cake", expected)
+	if actual != expected {
+		t.Errorf("Expected %v, found %v", expected, actual)
+	}
+}
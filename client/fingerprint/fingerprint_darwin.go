@@ -0,0 +1,5 @@
+package fingerprint
+
+func initPlatformFingerprints(fps map[string]Factory) {
+	fps["sensors"] = NewSensorsFingerprint
+}
@@ -1,4 +1,4 @@
-// +build darwin dragonfly freebsd netbsd openbsd solaris windows
+// +build dragonfly freebsd netbsd openbsd solaris windows
 
 package fingerprint
 
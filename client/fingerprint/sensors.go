@@ -0,0 +1,75 @@
+package fingerprint
+
+import (
+	"strconv"
+	"time"
+
+	log "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/lib/darwin"
+)
+
+const (
+	sensorsPending = "pending"
+	sensorsReady   = "ready"
+)
+
+// SensorsFingerprint is used to discover the hardware temperature sensors of
+// the host and the backend they are read through. Discovery walks the entire
+// SMC key space, so it is done once, in the background so as not to delay
+// the client's registration, and the resulting sensor set is reused by the
+// host stats collector. Until it completes the sensors are reported as
+// pending, and a later periodic fingerprint fills in their attributes. A
+// failed discovery is retried with a backoff, until one succeeds.
+type SensorsFingerprint struct {
+	logger log.Logger
+
+	// reported is set once the discovered sensors have been logged, and
+	// failed while discovery is failing, so that neither is logged on every
+	// fingerprint.
+	reported bool
+	failed   bool
+}
+
+// NewSensorsFingerprint is used to create a hardware sensors fingerprint
+func NewSensorsFingerprint(logger log.Logger) Fingerprint {
+	f := &SensorsFingerprint{logger: logger.Named("sensors")}
+	return f
+}
+
+func (f *SensorsFingerprint) Fingerprint(req *FingerprintRequest, resp *FingerprintResponse) error {
+	sensors, pending, err := darwin.DiscoverSensors()
+	if pending {
+		resp.AddAttribute("sensors.status", sensorsPending)
+		resp.Detected = true
+		return nil
+	}
+	if err != nil {
+		if err != darwin.ErrNotSupported {
+			if !f.failed {
+				f.logger.Warn("failed to discover temperature sensors, retrying", "error", err)
+				f.failed = true
+			}
+			resp.RemoveAttribute("sensors.status")
+		}
+		return nil
+	}
+	f.failed = false
+
+	temps := darwin.FilterSensors(sensors, darwin.KindTemperature)
+	if !f.reported {
+		f.logger.Debug("discovered temperature sensors", "count", len(temps))
+		f.reported = true
+	}
+	resp.AddAttribute("sensors.status", sensorsReady)
+	resp.AddAttribute("sensors.temperature.count", strconv.Itoa(len(temps)))
+	resp.AddAttribute("sensors.backend", string(darwin.SelectedBackend()))
+	resp.Detected = true
+	return nil
+}
+
+// Periodic re-runs the fingerprint so that the sensors are reported once
+// background discovery completes, and so that a failed discovery is retried.
+// Once it has succeeded, later runs only report the cached result.
+func (f *SensorsFingerprint) Periodic() (bool, time.Duration) {
+	return true, 15 * time.Second
+}
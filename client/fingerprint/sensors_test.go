@@ -0,0 +1,44 @@
+package fingerprint
+
+import (
+	"runtime"
+	"testing"
+
+	"github.com/hashicorp/nomad/client/config"
+	"github.com/hashicorp/nomad/helper/testlog"
+	"github.com/hashicorp/nomad/nomad/structs"
+	"github.com/stretchr/testify/require"
+)
+
+func TestSensorsFingerprint(t *testing.T) {
+	fp := NewSensorsFingerprint(testlog.HCLogger(t))
+	node := &structs.Node{
+		Attributes: make(map[string]string),
+	}
+
+	request := &FingerprintRequest{Config: new(config.Config), Node: node}
+	var response FingerprintResponse
+	require.NoError(t, fp.Fingerprint(request, &response))
+
+	if runtime.GOOS != "darwin" {
+		require.False(t, response.Detected)
+		require.Empty(t, response.Attributes)
+		return
+	}
+
+	// Discovery runs in the background, so the first fingerprint may only
+	// report it as pending.
+	if response.Attributes["sensors.status"] == sensorsPending {
+		require.True(t, response.Detected)
+		require.Len(t, response.Attributes, 1)
+		return
+	}
+
+	// Virtualized macOS hosts have no SMC, so only check the attributes when
+	// sensors were actually found.
+	if response.Detected {
+		require.Equal(t, sensorsReady, response.Attributes["sensors.status"])
+		assertNodeAttributeContains(t, response.Attributes, "sensors.temperature.count")
+		assertNodeAttributeContains(t, response.Attributes, "sensors.backend")
+	}
+}
@@ -1,6 +1,7 @@
 package interfaces
 
 import (
+	cstructs "github.com/hashicorp/nomad/client/structs"
 	"github.com/hashicorp/nomad/nomad/structs"
 	"github.com/hashicorp/nomad/plugins/device"
 )
@@ -21,3 +22,9 @@ type AllocStateHandler interface {
 type DeviceStatsReporter interface {
 	LatestDeviceResourceStats([]*structs.AllocatedDeviceResource) []*device.DeviceGroupStats
 }
+
+// PowerStatsReporter estimates the power drawn by a workload from its share of
+// the host's CPU usage
+type PowerStatsReporter interface {
+	LatestPowerStats(*cstructs.CpuStats) *cstructs.PowerStats
+}
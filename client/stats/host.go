@@ -21,9 +21,30 @@ type HostStats struct {
 	DiskStats        []*DiskStats
 	AllocDirStats    *DiskStats
 	DeviceStats      []*DeviceGroupStats
+	Temperatures     []*TemperatureStats
+	Thermal          *ThermalStats
+	Fans             []*FanStats
+	Power            []*PowerStats
+	Voltages         []*VoltageStats
+	SensorWindow     *SensorWindowStats
 	Uptime           uint64
 	Timestamp        int64
 	CPUTicksConsumed float64
+
+	// SensorTimestamp is when the sensor readings were taken, in nanoseconds
+	// since the Unix epoch, and SensorAge how old they were when these stats
+	// were served. Both are 0 if there are no readings.
+	SensorTimestamp int64
+	SensorAge       time.Duration
+
+	// TemperatureChanges holds the Temperatures that changed since they were
+	// last reported, which is all of them unless change-only reporting is
+	// enabled. Only these are published as metrics.
+	TemperatureChanges []*TemperatureStats `json:"-"`
+
+	// SensorReads describes the cost of reading hardware sensors. It is
+	// published as metrics by the client and not returned by the API.
+	SensorReads *SensorReadStats `json:"-"`
 }
 
 // MemoryStats represents stats related to virtual memory usage
@@ -41,6 +62,12 @@ type CPUStats struct {
 	System float64
 	Idle   float64
 	Total  float64
+
+	// Throttled is set while the host's performance is being limited, in
+	// which case FrequencyRatio is the fraction of its maximum speed the CPU
+	// runs at. FrequencyRatio is 1 on hosts that do not report limits.
+	Throttled      bool
+	FrequencyRatio float64
 }
 
 // DiskStats represents stats related to disk usage
@@ -75,6 +102,7 @@ type HostStatsCollector struct {
 	hostStatsLock        sync.RWMutex
 	allocDir             string
 	deviceStatsCollector DeviceStatsCollector
+	sensors              *sensorReader
 
 	// badParts is a set of partitions whose usage cannot be read; used to
 	// squelch logspam.
@@ -85,8 +113,8 @@ type HostStatsCollector struct {
 
 // NewHostStatsCollector returns a HostStatsCollector. The allocDir is passed in
 // so that we can present the disk related statistics for the mountpoint where
-// the allocation directory lives
-func NewHostStatsCollector(logger hclog.Logger, allocDir string, deviceStatsCollector DeviceStatsCollector) *HostStatsCollector {
+// the allocation directory lives. sensorConfig may be nil to use the defaults.
+func NewHostStatsCollector(logger hclog.Logger, allocDir string, deviceStatsCollector DeviceStatsCollector, sensorConfig *SensorConfig) *HostStatsCollector {
 	logger = logger.Named("host_stats")
 	numCores := runtime.NumCPU()
 	statsCalculator := make(map[string]*HostCpuStatsCalculator)
@@ -97,6 +125,7 @@ func NewHostStatsCollector(logger hclog.Logger, allocDir string, deviceStatsColl
 		allocDir:             allocDir,
 		badParts:             make(map[string]struct{}),
 		deviceStatsCollector: deviceStatsCollector,
+		sensors:              newSensorReader(logger, sensorConfig),
 	}
 	return collector
 }
@@ -139,6 +168,15 @@ func (h *HostStatsCollector) collectLocked() error {
 	hs.CPU = cpus
 	hs.CPUTicksConsumed = ticks
 
+	limits := h.sensors.collectPowerLimits()
+	for _, cpu := range cpus {
+		cpu.FrequencyRatio = 1
+		if limits != nil {
+			cpu.Throttled = limits.Throttled()
+			cpu.FrequencyRatio = limits.SpeedLimit
+		}
+	}
+
 	// Collect disk stats
 	diskStats, err := h.collectDiskStats()
 	if err != nil {
@@ -159,6 +197,14 @@ func (h *HostStatsCollector) collectLocked() error {
 	deviceStats := h.collectDeviceGroupStats()
 	hs.DeviceStats = deviceStats
 
+	// Collect hardware sensor stats
+	hs.Temperatures, hs.TemperatureChanges = h.sensors.collectTemperatureStats()
+	hs.Thermal = h.sensors.collectThermalStats(hs.Temperatures)
+	hs.Fans, hs.Power, hs.Voltages = h.sensors.collectSensorStats()
+	hs.SensorTimestamp = h.sensors.collectTimestamp()
+	hs.SensorWindow = h.sensors.collectWindowStats()
+	hs.SensorReads = h.sensors.collectReadStats()
+
 	// Update the collected status object.
 	h.hostStats = hs
 
@@ -216,7 +262,8 @@ func (h *HostStatsCollector) collectDeviceGroupStats() []*DeviceGroupStats {
 	return h.deviceStatsCollector()
 }
 
-// Stats returns the host stats that has been collected
+// Stats returns the host stats that has been collected, with the latest
+// readings of the background sensor sampler if it is enabled
 func (h *HostStatsCollector) Stats() *HostStats {
 	h.hostStatsLock.RLock()
 	defer h.hostStatsLock.RUnlock()
@@ -227,7 +274,15 @@ func (h *HostStatsCollector) Stats() *HostStats {
 		}
 	}
 
-	return h.hostStats
+	return h.sensors.serve(h.hostStats, time.Now())
+}
+
+// Shutdown stops reading hardware sensors and releases the native resources
+// used to read them. Host stats collected afterwards have no sensor readings.
+func (h *HostStatsCollector) Shutdown() {
+	h.hostStatsLock.Lock()
+	defer h.hostStatsLock.Unlock()
+	h.sensors.close()
 }
 
 // toDiskStats merges UsageStat and PartitionStat to create a DiskStat
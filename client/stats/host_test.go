@@ -1,9 +1,14 @@
 package stats
 
 import (
+	"os"
+	"runtime"
 	"testing"
+	"time"
 
+	hclog "github.com/hashicorp/go-hclog"
 	"github.com/shirou/gopsutil/v3/cpu"
+	"github.com/stretchr/testify/require"
 )
 
 func TestHostCpuStatsCalculator_Nan(t *testing.T) {
@@ -30,3 +35,56 @@ func TestHostCpuStatsCalculator_Nan(t *testing.T) {
 		t.Errorf("total: Expected: %f, Got %f", 0.0, total)
 	}
 }
+
+func TestHostStatsCollector_CPUUnthrottled(t *testing.T) {
+	if runtime.GOOS == "darwin" {
+		t.Skip("power limits are reported on darwin")
+	}
+
+	cwd, err := os.Getwd()
+	require.NoError(t, err)
+	collector := NewHostStatsCollector(hclog.NewNullLogger(), cwd, nil, nil)
+	require.NoError(t, collector.Collect())
+
+	for _, cpu := range collector.Stats().CPU {
+		require.False(t, cpu.Throttled)
+		require.Equal(t, 1.0, cpu.FrequencyRatio)
+	}
+}
+
+func TestSensorReader_ServeMaxStaleness(t *testing.T) {
+	s := newSensorReader(hclog.NewNullLogger(), &SensorConfig{MaxStaleness: time.Second})
+	now := time.Now()
+	hs := &HostStats{
+		Temperatures:    []*TemperatureStats{{Sensor: "TC0P", Celsius: 50}},
+		Fans:            []*FanStats{{Sensor: "F0Ac", RPM: 1200}},
+		SensorTimestamp: now.Add(-500 * time.Millisecond).UnixNano(),
+	}
+
+	served := s.serve(hs, now)
+	require.Len(t, served.Temperatures, 1)
+	require.Len(t, served.Fans, 1)
+	require.Equal(t, 500*time.Millisecond, served.SensorAge)
+
+	served = s.serve(hs, now.Add(time.Second))
+	require.Empty(t, served.Temperatures)
+	require.Empty(t, served.Fans)
+	require.Equal(t, 1500*time.Millisecond, served.SensorAge)
+
+	// The collected stats are shared and must be left untouched.
+	require.Len(t, hs.Temperatures, 1)
+	require.Len(t, hs.Fans, 1)
+	require.Zero(t, hs.SensorAge)
+}
+
+func BenchmarkHostStatsCollector_Collect(b *testing.B) {
+	cwd, err := os.Getwd()
+	require.NoError(b, err)
+	collector := NewHostStatsCollector(hclog.NewNullLogger(), cwd, nil, nil)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		require.NoError(b, collector.Collect())
+	}
+}
@@ -0,0 +1,55 @@
+package stats
+
+import "math"
+
+// defaultPowerSensor is the sensor host power is attributed from when none is
+// configured: the CPU package power reported by the SMC.
+const defaultPowerSensor = "PCPC"
+
+// PowerAttribution is the host power that is attributed to workloads by their
+// share of the host's CPU usage
+type PowerAttribution struct {
+	// Sensor is the power sensor attributed from and Watts its reading
+	Sensor string
+	Watts  float64
+
+	// CPUPercent is the host's CPU usage that Watts is attributed across,
+	// as the sum of the usage of each core in percent
+	CPUPercent float64
+}
+
+// Share returns the fraction of the host's power attributed to a workload
+// using cpuPercent of the host's CPU, in the units of CPUPercent. The CPU usage
+// of a workload and of the host are collected at different times, so the
+// share is capped at 1.
+func (a *PowerAttribution) Share(cpuPercent float64) float64 {
+	if a.CPUPercent <= 0 || cpuPercent <= 0 {
+		return 0
+	}
+	return math.Min(cpuPercent/a.CPUPercent, 1)
+}
+
+// PowerAttribution returns the host power to attribute to workloads, or nil if
+// the configured power sensor cannot currently be read.
+func (h *HostStatsCollector) PowerAttribution() *PowerAttribution {
+	return newPowerAttribution(h.Stats(), h.sensors.config.PowerSensor)
+}
+
+func newPowerAttribution(hs *HostStats, sensor string) *PowerAttribution {
+	if sensor == "" {
+		sensor = defaultPowerSensor
+	}
+
+	for _, power := range hs.Power {
+		if power.Sensor != sensor {
+			continue
+		}
+
+		a := &PowerAttribution{Sensor: sensor, Watts: power.Watts}
+		for _, cpu := range hs.CPU {
+			a.CPUPercent += cpu.Total
+		}
+		return a
+	}
+	return nil
+}
@@ -0,0 +1,39 @@
+package stats
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+)
+
+func TestPowerAttribution(t *testing.T) {
+	hs := &HostStats{
+		CPU: []*CPUStats{
+			{CPU: "cpu0", Total: 60},
+			{CPU: "cpu1", Total: 20},
+		},
+		Power: []*PowerStats{
+			{Sensor: "PSTR", Watts: 30},
+			{Sensor: "PCPC", Watts: 12},
+		},
+	}
+
+	a := newPowerAttribution(hs, "")
+	require.Equal(t, &PowerAttribution{Sensor: "PCPC", Watts: 12, CPUPercent: 80}, a)
+	require.Equal(t, 0.25, a.Share(20))
+	require.Zero(t, a.Share(0))
+
+	// The share cannot exceed the host's usage.
+	require.Equal(t, 1.0, a.Share(120))
+
+	a = newPowerAttribution(hs, "PSTR")
+	require.Equal(t, 30.0, a.Watts)
+
+	// Nothing is attributed without a reading of the sensor.
+	require.Nil(t, newPowerAttribution(hs, "VD0R"))
+	require.Nil(t, newPowerAttribution(&HostStats{}, ""))
+
+	// Nor by an idle host.
+	idle := &HostStats{Power: hs.Power}
+	require.Zero(t, newPowerAttribution(idle, "").Share(20))
+}
@@ -0,0 +1,699 @@
+package stats
+
+import (
+	"sync"
+	"time"
+
+	hclog "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/lib/darwin"
+	"github.com/hashicorp/nomad/lib/sensors"
+)
+
+// sensorOpenRetry is how long collections go on without sensors after they
+// failed to open before opening them is attempted again.
+const sensorOpenRetry = time.Minute
+
+// TemperatureStats represents the reading of a host temperature sensor
+type TemperatureStats struct {
+	Sensor  string
+	Celsius float64
+}
+
+// FanStats represents the speed of a host fan
+type FanStats struct {
+	Sensor string
+	RPM    float64
+}
+
+// PowerStats represents the reading of a host power sensor, such as PSTR for
+// the whole system or PCPC for the CPU package
+type PowerStats struct {
+	Sensor string
+	Watts  float64
+}
+
+// VoltageStats represents the reading of a host voltage sensor
+type VoltageStats struct {
+	Sensor string
+	Volts  float64
+}
+
+// SensorWindowStats summarizes every sensor over the last complete window of
+// the background sampler
+type SensorWindowStats struct {
+	// Start and End are nanoseconds since the Unix epoch.
+	Start   int64
+	End     int64
+	Sensors []*SensorAggregateStats
+}
+
+// SensorAggregateStats summarizes the readings of one sensor over a window.
+// P95 is estimated, and EWMA is the moving average at the end of the window.
+type SensorAggregateStats struct {
+	Sensor  string
+	Samples int
+	Min     float64
+	Max     float64
+	Mean    float64
+	P95     float64
+	EWMA    float64
+}
+
+// SensorThreshold holds the high and low watermarks of a sensor; see
+// darwin.Threshold.
+type SensorThreshold = darwin.Threshold
+
+// SensorThresholdEvent is raised when a sensor crosses one of its
+// watermarks, either reaching it or returning past it by the hysteresis.
+// Level and Previous are "normal", "high" or "low", and Watermark is the
+// watermark that was crossed.
+type SensorThresholdEvent struct {
+	Sensor    string
+	Timestamp time.Time
+	Level     string
+	Previous  string
+	Value     float64
+	Watermark float64
+}
+
+// SensorReadStats are the counters and latency histograms kept by the native
+// sensor layer.
+type SensorReadStats = darwin.Stats
+
+// SensorConfig configures how hardware sensors are read by the
+// HostStatsCollector.
+type SensorConfig struct {
+	// SamplerEnabled reads sensors on a native background thread instead of
+	// during collection, so that collecting host stats only copies the
+	// latest snapshot.
+	SamplerEnabled bool
+
+	// SamplerInterval is how often the background sampler reads sensors.
+	SamplerInterval time.Duration
+
+	// SamplerMaxInterval lets the sampler back off up to this interval while
+	// readings are stable, as long as their variance stays below
+	// SamplerVarianceThreshold. It returns to SamplerInterval when a reading
+	// changes faster than SamplerRateThreshold per second. Adaptation is
+	// disabled unless SamplerMaxInterval is above SamplerInterval.
+	SamplerMaxInterval       time.Duration
+	SamplerVarianceThreshold float64
+	SamplerRateThreshold     float64
+
+	// SamplerWorkers is the number of threads the sampler reads sensors
+	// with in parallel.
+	SamplerWorkers int
+
+	// SamplerWindow, when set, has the sampler summarize each sensor over
+	// consecutive windows of this length, with a moving average whose time
+	// constant is SamplerEWMATimeConstant.
+	SamplerWindow           time.Duration
+	SamplerEWMATimeConstant time.Duration
+
+	// CriticalCelsius is the temperature at which the host throttles, from
+	// which thermal headroom is measured. Defaults to 100°C.
+	CriticalCelsius float64
+
+	// ThermalTimeConstant is the time constant of the moving average of the
+	// hottest sensor. Defaults to one minute.
+	ThermalTimeConstant time.Duration
+
+	// ChangeEpsilon enables change-only reporting when set: a collection
+	// only reports the readings that moved by more than ChangeEpsilon since
+	// they were last reported.
+	ChangeEpsilon float64
+
+	// ChangeRefresh is how long a reading may go unreported under
+	// change-only reporting before it is reported again anyway.
+	ChangeRefresh time.Duration
+
+	// MaxStaleness, when set, is the oldest sensor readings may be when
+	// host stats are served; older readings are left out.
+	MaxStaleness time.Duration
+
+	// PowerSensor is the power sensor attributed to workloads by their
+	// share of the host's CPU usage. It defaults to the CPU package power.
+	PowerSensor string
+
+	// Thresholds holds the watermarks of sensors by key. The background
+	// sampler checks every reading against them and calls OnThreshold
+	// whenever a sensor crosses one, so that nothing has to poll for it.
+	Thresholds  map[string]SensorThreshold
+	OnThreshold func(*SensorThresholdEvent)
+}
+
+// sensorReader samples the hardware sensors of the host. Only sensors known to
+// exist are read, together, either during collection through the native
+// interface of the platform or, on macOS, from the background sampler.
+type sensorReader struct {
+	logger hclog.Logger
+	config SensorConfig
+
+	// disabled is set once hardware sensors are found to be unsupported on
+	// this platform, or once the reader is closed. Other failures to open
+	// the sensors are retried, no sooner than retryAt.
+	disabled bool
+	retryAt  time.Time
+
+	// sensors holds the temperature sensors first, followed by the fan,
+	// power and voltage sensors, so that all of them are read together.
+	sensors []sensors.Sensor
+	temps   int
+
+	// reader is used when reading sensors synchronously; the readings are
+	// read into values and ok.
+	reader sensors.Reader
+	values []float64
+	ok     []bool
+
+	// smc is used to read the power limits, for which it is opened on
+	// demand. noLimits is set if they cannot be read on this host.
+	smc      *darwin.SMC
+	noLimits bool
+
+	// last holds the values and ok of the latest read, which the
+	// temperatures and the other sensors are both reported from, and when
+	// it was taken.
+	lastValues []float64
+	lastOK     []bool
+	lastRead   time.Time
+
+	// sampler, snapshot and aggregates are used when the background sampler
+	// is enabled. window caches the stats of the window in aggregates.
+	sampler    *darwin.Sampler
+	snapshot   darwin.Snapshot
+	aggregates darwin.Aggregates
+	window     *SensorWindowStats
+
+	// watcher tracks the goroutine forwarding the sampler's threshold
+	// events, which exits once the sampler is stopped.
+	watcher sync.WaitGroup
+
+	// served holds the readings of the sampler's latest snapshot, which
+	// are served between collections. It is guarded by servedLock since
+	// host stats may be served concurrently with each other and with a
+	// collection.
+	servedLock     sync.Mutex
+	servedSnapshot darwin.Snapshot
+	served         *sensorReadings
+
+	thermal *thermalTracker
+
+	// delta, reported and changed are used for change-only reporting.
+	// reported holds the stats last reported for each sensor, which are
+	// shared between collections and so never modified.
+	delta    *sensors.DeltaFilter
+	reported []*TemperatureStats
+	changed  []int
+}
+
+func newSensorReader(logger hclog.Logger, config *SensorConfig) *sensorReader {
+	s := &sensorReader{logger: logger}
+	if config != nil {
+		s.config = *config
+	}
+	s.thermal = newThermalTracker(s.config.CriticalCelsius, s.config.ThermalTimeConstant)
+	if s.config.ChangeEpsilon > 0 {
+		s.delta = &sensors.DeltaFilter{
+			Epsilon: s.config.ChangeEpsilon,
+			Refresh: s.config.ChangeRefresh,
+		}
+	}
+	return s
+}
+
+// init resolves the set of sensors to sample, returning false if there is
+// nothing to read.
+func (s *sensorReader) init() bool {
+	if s.disabled {
+		return false
+	}
+	if s.sensors != nil {
+		return true
+	}
+	if time.Now().Before(s.retryAt) {
+		return false
+	}
+
+	// Discovery runs in the background; until it completes collections go on
+	// without sensors rather than waiting for it. A failed discovery is
+	// retried in the background as well, once its backoff has passed.
+	if _, pending, err := darwin.DiscoverSensors(); pending || (err != nil && err != darwin.ErrNotSupported) {
+		return false
+	}
+
+	if s.config.SamplerEnabled && s.startSampler() {
+		return true
+	}
+	if len(s.config.Thresholds) > 0 {
+		s.logger.Warn("sensor thresholds require the background sensor sampler and are ignored")
+	}
+
+	reader, err := sensors.Open()
+	if err == sensors.ErrNotSupported {
+		s.disabled = true
+		return false
+	}
+	if err != nil {
+		s.logger.Warn("failed to open hardware sensors", "error", err, "retry_in", sensorOpenRetry)
+		s.retryAt = time.Now().Add(sensorOpenRetry)
+		return false
+	}
+
+	s.reader = reader
+	s.setSensors(reader.Sensors())
+	s.values = make([]float64, len(s.sensors))
+	s.ok = make([]bool, len(s.sensors))
+	return true
+}
+
+// setSensors sets the sensors to read, which are ordered by kind.
+func (s *sensorReader) setSensors(found []sensors.Sensor) {
+	s.sensors = found
+	s.temps = 0
+	for _, sensor := range found {
+		if sensor.Kind == sensors.KindTemperature {
+			s.temps++
+		}
+	}
+	s.reported = make([]*TemperatureStats, s.temps)
+}
+
+// startSampler starts the background sampler over the SMC sensors, returning
+// false if they are not available or it cannot be started.
+func (s *sensorReader) startSampler() bool {
+	discovered, err := darwin.Sensors()
+	if err != nil {
+		return false
+	}
+
+	native, found := sensors.OrderDarwin(discovered)
+	if len(native) == 0 {
+		return false
+	}
+
+	sampler, err := darwin.StartSampler(native, darwin.SamplerConfig{
+		MinInterval:       s.config.SamplerInterval,
+		MaxInterval:       s.config.SamplerMaxInterval,
+		VarianceThreshold: s.config.SamplerVarianceThreshold,
+		RateThreshold:     s.config.SamplerRateThreshold,
+		Workers:           s.config.SamplerWorkers,
+		Window:            s.config.SamplerWindow,
+		EWMATimeConstant:  s.config.SamplerEWMATimeConstant,
+	})
+	if err != nil {
+		s.logger.Warn("failed to start sensor sampler, reading sensors during collection", "error", err)
+		return false
+	}
+
+	s.sampler = sampler
+	s.setSensors(found)
+	s.watchThresholds()
+	return true
+}
+
+// read fills values and ok with the latest readings, returning false if
+// none are available. The readings are kept in lastValues and lastOK until
+// the next read.
+func (s *sensorReader) read() (values []float64, ok []bool, read bool) {
+	s.lastValues, s.lastOK, s.lastRead = nil, nil, time.Time{}
+
+	if s.sampler != nil {
+		if !s.sampler.Latest(&s.snapshot) {
+			return nil, nil, false
+		}
+		s.lastValues, s.lastOK = s.snapshot.Values, s.snapshot.OK
+		s.lastRead = s.snapshot.Timestamp
+		return s.lastValues, s.lastOK, true
+	}
+
+	if err := s.reader.Read(s.values, s.ok); err != nil {
+		s.logger.Debug("failed to read hardware sensors", "error", err)
+		return nil, nil, false
+	}
+	s.lastValues, s.lastOK, s.lastRead = s.values, s.ok, time.Now()
+	return s.values, s.ok, true
+}
+
+// collectTemperatureStats reads every sensor and returns the current
+// temperature of each temperature sensor that could be read, along with the
+// subset that changed and should be reported. Without change-only reporting
+// both are the same.
+func (s *sensorReader) collectTemperatureStats() (temps, changed []*TemperatureStats) {
+	if !s.init() || len(s.sensors) == 0 {
+		return []*TemperatureStats{}, nil
+	}
+
+	values, ok, read := s.read()
+	if !read {
+		return []*TemperatureStats{}, nil
+	}
+	values, ok = values[:s.temps], ok[:s.temps]
+
+	if s.delta == nil {
+		temps = make([]*TemperatureStats, 0, s.temps)
+		for i, sensor := range s.sensors[:s.temps] {
+			if !ok[i] {
+				continue
+			}
+			temps = append(temps, &TemperatureStats{
+				Sensor:  sensor.Name,
+				Celsius: values[i],
+			})
+		}
+		return temps, temps
+	}
+
+	// Only changed readings get new stats; the others keep the ones that
+	// were last reported.
+	s.changed = s.delta.Changed(s.changed[:0], values, ok, time.Now())
+	changed = make([]*TemperatureStats, 0, len(s.changed))
+	for _, i := range s.changed {
+		temp := &TemperatureStats{
+			Sensor:  s.sensors[i].Name,
+			Celsius: values[i],
+		}
+		s.reported[i] = temp
+		changed = append(changed, temp)
+	}
+
+	temps = make([]*TemperatureStats, 0, s.temps)
+	for i, temp := range s.reported {
+		if !ok[i] {
+			s.reported[i] = nil
+			continue
+		}
+		temps = append(temps, temp)
+	}
+	return temps, changed
+}
+
+// collectSensorStats returns the fan, power and voltage readings taken by the
+// preceding collectTemperatureStats. They are always reported in full;
+// change-only reporting applies to temperatures alone.
+func (s *sensorReader) collectSensorStats() (fans []*FanStats, power []*PowerStats, voltages []*VoltageStats) {
+	if s.disabled || s.lastValues == nil {
+		return nil, nil, nil
+	}
+	return s.sensorStats(s.lastValues, s.lastOK)
+}
+
+// sensorStats converts the fan, power and voltage readings of values and ok
+// into stats.
+func (s *sensorReader) sensorStats(values []float64, ok []bool) (fans []*FanStats, power []*PowerStats, voltages []*VoltageStats) {
+	for i := s.temps; i < len(s.sensors); i++ {
+		if !ok[i] {
+			continue
+		}
+
+		sensor, value := s.sensors[i], values[i]
+		switch sensor.Kind {
+		case sensors.KindFan:
+			fans = append(fans, &FanStats{Sensor: sensor.Name, RPM: value})
+		case sensors.KindPower:
+			power = append(power, &PowerStats{Sensor: sensor.Name, Watts: value})
+		case sensors.KindVoltage:
+			voltages = append(voltages, &VoltageStats{Sensor: sensor.Name, Volts: value})
+		}
+	}
+	return fans, power, voltages
+}
+
+// watchThresholds arms the configured thresholds on the sampler and, if any
+// were armed, forwards its events to OnThreshold until the sampler stops,
+// which close waits for.
+func (s *sensorReader) watchThresholds() {
+	if len(s.config.Thresholds) == 0 || s.config.OnThreshold == nil {
+		return
+	}
+
+	thresholds := make(map[int]SensorThreshold, len(s.config.Thresholds))
+	for i, sensor := range s.sensors {
+		threshold, ok := s.config.Thresholds[sensor.Name]
+		if !ok {
+			continue
+		}
+		if err := s.sampler.SetThreshold(i, threshold); err != nil {
+			s.logger.Warn("failed to set sensor threshold", "sensor", sensor.Name, "error", err)
+			continue
+		}
+		thresholds[i] = threshold
+	}
+
+	for key := range s.config.Thresholds {
+		if !s.hasSensor(key) {
+			s.logger.Warn("ignoring threshold of unknown sensor", "sensor", key)
+		}
+	}
+	if len(thresholds) == 0 {
+		return
+	}
+
+	s.watcher.Add(1)
+	go func() {
+		defer s.watcher.Done()
+
+		var events []darwin.ThresholdEvent
+		var dropped uint64
+		for {
+			var ok bool
+			events, ok = s.sampler.WaitEvents(events[:0], time.Minute)
+			if !ok {
+				return
+			}
+
+			for _, event := range events {
+				s.config.OnThreshold(newSensorThresholdEvent(s.sensors[event.Sensor].Name, thresholds[event.Sensor], event))
+			}
+
+			if n := s.sampler.DroppedEvents(); n != dropped {
+				s.logger.Warn("dropped sensor threshold events", "count", n-dropped)
+				dropped = n
+			}
+		}
+	}()
+}
+
+// hasSensor reports whether a sensor with the given key is being read.
+func (s *sensorReader) hasSensor(key string) bool {
+	for _, sensor := range s.sensors {
+		if sensor.Name == key {
+			return true
+		}
+	}
+	return false
+}
+
+// newSensorThresholdEvent converts an event of the sampler for the sensor
+// with the given key and threshold.
+func newSensorThresholdEvent(key string, threshold SensorThreshold, event darwin.ThresholdEvent) *SensorThresholdEvent {
+	watermark := threshold.High
+	if event.Level == darwin.LevelLow || (event.Level == darwin.LevelNormal && event.Previous == darwin.LevelLow) {
+		watermark = threshold.Low
+	}
+
+	return &SensorThresholdEvent{
+		Sensor:    key,
+		Timestamp: event.Timestamp,
+		Level:     event.Level.String(),
+		Previous:  event.Previous.String(),
+		Value:     event.Value,
+		Watermark: watermark,
+	}
+}
+
+// collectTimestamp returns when the readings of the preceding
+// collectTemperatureStats were taken, in nanoseconds since the Unix epoch, or
+// 0 if there are none.
+func (s *sensorReader) collectTimestamp() int64 {
+	if s.lastRead.IsZero() {
+		return 0
+	}
+	return s.lastRead.UnixNano()
+}
+
+// sensorReadings are the readings of a snapshot of the background sampler, as
+// they are served.
+type sensorReadings struct {
+	timestamp    int64
+	temperatures []*TemperatureStats
+	fans         []*FanStats
+	power        []*PowerStats
+	voltages     []*VoltageStats
+}
+
+// serve returns the host stats to serve at now. When the background sampler
+// has taken a snapshot since hs was collected, its readings replace those of
+// hs; this only copies memory, so host stats can be served at any rate
+// without reading sensors. Readings older than MaxStaleness are left out.
+// hs itself is never modified.
+func (s *sensorReader) serve(hs *HostStats, now time.Time) *HostStats {
+	served := *hs
+
+	if readings := s.latestReadings(); readings != nil && readings.timestamp > served.SensorTimestamp {
+		served.SensorTimestamp = readings.timestamp
+		served.Temperatures = readings.temperatures
+		served.Fans = readings.fans
+		served.Power = readings.power
+		served.Voltages = readings.voltages
+	}
+
+	if served.SensorTimestamp == 0 {
+		return &served
+	}
+
+	served.SensorAge = now.Sub(time.Unix(0, served.SensorTimestamp))
+	if s.config.MaxStaleness > 0 && served.SensorAge > s.config.MaxStaleness {
+		served.Temperatures = []*TemperatureStats{}
+		served.Fans, served.Power, served.Voltages = nil, nil, nil
+	}
+	return &served
+}
+
+// latestReadings returns the readings of the sampler's latest snapshot, or nil
+// if the sampler is not running or has not completed a pass yet. The readings
+// of a snapshot are shared between the callers that serve it.
+func (s *sensorReader) latestReadings() *sensorReadings {
+	s.servedLock.Lock()
+	defer s.servedLock.Unlock()
+
+	if s.sampler == nil || !s.sampler.Latest(&s.servedSnapshot) {
+		return nil
+	}
+
+	timestamp := s.servedSnapshot.Timestamp.UnixNano()
+	if s.served != nil && s.served.timestamp == timestamp {
+		return s.served
+	}
+
+	values, ok := s.servedSnapshot.Values, s.servedSnapshot.OK
+	readings := &sensorReadings{
+		timestamp:    timestamp,
+		temperatures: make([]*TemperatureStats, 0, s.temps),
+	}
+	for i, sensor := range s.sensors[:s.temps] {
+		if !ok[i] {
+			continue
+		}
+		readings.temperatures = append(readings.temperatures, &TemperatureStats{
+			Sensor:  sensor.Name,
+			Celsius: values[i],
+		})
+	}
+	readings.fans, readings.power, readings.voltages = s.sensorStats(values, ok)
+	s.served = readings
+	return readings
+}
+
+// collectWindowStats returns the aggregates of the sampler's last complete
+// window, or nil if there are none. The stats of a window are shared between
+// the collections that report it.
+func (s *sensorReader) collectWindowStats() *SensorWindowStats {
+	if s.disabled || s.sampler == nil || !s.sampler.Aggregates(&s.aggregates) {
+		return nil
+	}
+
+	end := s.aggregates.WindowEnd.UnixNano()
+	if s.window != nil && s.window.End == end {
+		return s.window
+	}
+
+	window := &SensorWindowStats{
+		Start:   s.aggregates.WindowStart.UnixNano(),
+		End:     end,
+		Sensors: make([]*SensorAggregateStats, 0, len(s.sensors)),
+	}
+	for i, agg := range s.aggregates.Sensors {
+		if agg.Count == 0 {
+			continue
+		}
+		window.Sensors = append(window.Sensors, &SensorAggregateStats{
+			Sensor:  s.sensors[i].Name,
+			Samples: agg.Count,
+			Min:     agg.Min,
+			Max:     agg.Max,
+			Mean:    agg.Mean,
+			P95:     agg.P95,
+			EWMA:    agg.EWMA,
+		})
+	}
+	s.window = window
+	return window
+}
+
+// collectPowerLimits returns the performance limits currently in effect, or
+// nil if they cannot be read.
+func (s *sensorReader) collectPowerLimits() *darwin.PowerLimits {
+	if !s.init() || s.noLimits {
+		return nil
+	}
+
+	if s.smc == nil {
+		smc, err := darwin.Open()
+		if err == darwin.ErrNotSupported {
+			s.noLimits = true
+			return nil
+		}
+		if err != nil {
+			s.logger.Debug("failed to open connection to read power limits", "error", err)
+			return nil
+		}
+		s.smc = smc
+	}
+
+	limits, err := s.smc.ReadPowerLimits()
+	if err != nil {
+		s.logger.Debug("failed to read power limits", "error", err)
+		return nil
+	}
+	return limits
+}
+
+// collectThermalStats folds temps into the moving average of the hottest
+// sensor, returning nil if no temperature has been read yet.
+func (s *sensorReader) collectThermalStats(temps []*TemperatureStats) *ThermalStats {
+	if s.disabled {
+		return nil
+	}
+	return s.thermal.update(temps, time.Now())
+}
+
+// collectReadStats returns the counters of the native sensor layer, or nil if
+// sensors are not being read.
+func (s *sensorReader) collectReadStats() *SensorReadStats {
+	if s.disabled {
+		return nil
+	}
+
+	stats, err := darwin.ReadStats()
+	if err != nil {
+		return nil
+	}
+	return stats
+}
+
+// close stops the background sampler and releases every connection used to
+// read sensors. Nothing is read afterwards.
+func (s *sensorReader) close() {
+	s.disabled = true
+
+	// Stopping the sampler ends the threshold watcher, which may still be
+	// delivering the events it last received.
+	if s.sampler != nil {
+		s.sampler.Stop()
+		s.watcher.Wait()
+		s.sampler = nil
+	}
+	if s.reader != nil {
+		if err := s.reader.Close(); err != nil {
+			s.logger.Debug("failed to close hardware sensors", "error", err)
+		}
+		s.reader = nil
+	}
+	if s.smc != nil {
+		if err := s.smc.Close(); err != nil {
+			s.logger.Debug("failed to close connection to read power limits", "error", err)
+		}
+		s.smc = nil
+	}
+}
@@ -0,0 +1,130 @@
+package stats
+
+import (
+	"runtime"
+	"testing"
+	"time"
+
+	hclog "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/helper/testlog"
+	"github.com/hashicorp/nomad/lib/darwin"
+	"github.com/hashicorp/nomad/lib/sensors"
+	"github.com/stretchr/testify/require"
+)
+
+func TestSensorReader_Unsupported(t *testing.T) {
+	switch runtime.GOOS {
+	case "darwin", "linux":
+		t.Skip("hardware sensors may be supported on " + runtime.GOOS)
+	}
+
+	s := newSensorReader(testlog.HCLogger(t), nil)
+	temps, changed := s.collectTemperatureStats()
+	require.Empty(t, temps)
+	require.Empty(t, changed)
+	require.True(t, s.disabled)
+
+	// Subsequent collections must not retry discovery.
+	temps, _ = s.collectTemperatureStats()
+	require.Empty(t, temps)
+	require.Nil(t, s.collectWindowStats())
+}
+
+func TestSensorReader_ThresholdEvent(t *testing.T) {
+	threshold := SensorThreshold{High: 95, Low: 10, Hysteresis: 2}
+	now := time.Now()
+
+	cases := []struct {
+		level, previous darwin.Level
+		watermark       float64
+	}{
+		{darwin.LevelHigh, darwin.LevelNormal, 95},
+		{darwin.LevelNormal, darwin.LevelHigh, 95},
+		{darwin.LevelLow, darwin.LevelNormal, 10},
+		{darwin.LevelNormal, darwin.LevelLow, 10},
+		{darwin.LevelLow, darwin.LevelHigh, 10},
+	}
+	for _, c := range cases {
+		event := newSensorThresholdEvent("TC0P", threshold, darwin.ThresholdEvent{
+			Timestamp: now,
+			Level:     c.level,
+			Previous:  c.previous,
+			Value:     50,
+		})
+		require.Equal(t, "TC0P", event.Sensor)
+		require.Equal(t, c.level.String(), event.Level)
+		require.Equal(t, c.previous.String(), event.Previous)
+		require.Equal(t, c.watermark, event.Watermark)
+		require.Equal(t, now, event.Timestamp)
+	}
+}
+
+func benchmarkSensorReader(b *testing.B, config *SensorConfig) {
+	// Wait for background discovery so that the first collection has the
+	// sensors to read.
+	for {
+		if _, pending, _ := darwin.DiscoverSensors(); !pending {
+			break
+		}
+		time.Sleep(10 * time.Millisecond)
+	}
+
+	s := newSensorReader(hclog.NewNullLogger(), config)
+	s.collectTemperatureStats()
+	if s.disabled {
+		b.Skip("hardware sensors are not supported on this host")
+	}
+	defer s.close()
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		s.collectTemperatureStats()
+	}
+}
+
+func BenchmarkSensorReader_Collect(b *testing.B) {
+	benchmarkSensorReader(b, nil)
+}
+
+func BenchmarkSensorReader_Collect_Sampler(b *testing.B) {
+	benchmarkSensorReader(b, &SensorConfig{
+		SamplerEnabled:  true,
+		SamplerInterval: time.Second,
+	})
+}
+
+func TestSensorReader_Close(t *testing.T) {
+	s := newSensorReader(testlog.HCLogger(t), &SensorConfig{SamplerEnabled: true})
+	s.close()
+	require.True(t, s.disabled)
+	require.Nil(t, s.sampler)
+	require.Nil(t, s.reader)
+	require.Nil(t, s.smc)
+
+	// Nothing is read once closed, and closing again is harmless.
+	temps, changed := s.collectTemperatureStats()
+	require.Empty(t, temps)
+	require.Empty(t, changed)
+	require.Nil(t, s.collectWindowStats())
+	s.close()
+}
+
+func TestSensorReader_CollectSensorStats(t *testing.T) {
+	s := newSensorReader(testlog.HCLogger(t), nil)
+	s.sensors = []sensors.Sensor{
+		{Name: "TC0P", Kind: sensors.KindTemperature},
+		{Name: "F0Ac", Kind: sensors.KindFan},
+		{Name: "PSTR", Kind: sensors.KindPower},
+		{Name: "PCPC", Kind: sensors.KindPower},
+		{Name: "VC0C", Kind: sensors.KindVoltage},
+	}
+	s.temps = 1
+	s.lastValues = []float64{50, 2000, 12.5, 4, 1.1}
+	s.lastOK = []bool{true, true, true, false, true}
+
+	fans, power, voltages := s.collectSensorStats()
+	require.Equal(t, []*FanStats{{Sensor: "F0Ac", RPM: 2000}}, fans)
+	require.Equal(t, []*PowerStats{{Sensor: "PSTR", Watts: 12.5}}, power)
+	require.Equal(t, []*VoltageStats{{Sensor: "VC0C", Volts: 1.1}}, voltages)
+}
@@ -0,0 +1,78 @@
+package stats
+
+import (
+	"math"
+	"time"
+)
+
+const (
+	// defaultCriticalCelsius is the temperature at which hosts are assumed to
+	// throttle when no critical temperature is configured.
+	defaultCriticalCelsius = 100.0
+
+	// defaultThermalTimeConstant is the time constant of the moving average
+	// when none is configured. A reading is weighted by 1-1/e after this long.
+	defaultThermalTimeConstant = time.Minute
+)
+
+// ThermalStats summarizes how close the host is to thermal throttling
+type ThermalStats struct {
+	// MaxCelsius is an exponentially weighted moving average of the hottest
+	// sensor.
+	MaxCelsius float64
+
+	// HeadroomCelsius is how far MaxCelsius is below the critical
+	// temperature, or 0 once it has reached it.
+	HeadroomCelsius float64
+}
+
+// thermalTracker smooths the hottest sensor reading over time so that short
+// spikes do not make a node look throttled.
+type thermalTracker struct {
+	critical float64
+	tau      time.Duration
+
+	// ewma is the smoothed temperature as of last, which is zero until the
+	// first reading.
+	ewma float64
+	last time.Time
+}
+
+func newThermalTracker(critical float64, tau time.Duration) *thermalTracker {
+	if critical <= 0 {
+		critical = defaultCriticalCelsius
+	}
+	if tau <= 0 {
+		tau = defaultThermalTimeConstant
+	}
+	return &thermalTracker{critical: critical, tau: tau}
+}
+
+// update folds in the temperatures read at now and returns the resulting
+// stats, or nil if nothing has been read yet. The weight of each reading
+// depends on the time since the previous one, so irregular collection
+// intervals do not skew the average.
+func (t *thermalTracker) update(temps []*TemperatureStats, now time.Time) *ThermalStats {
+	max := math.Inf(-1)
+	for _, temp := range temps {
+		max = math.Max(max, temp.Celsius)
+	}
+
+	if !math.IsInf(max, -1) {
+		if t.last.IsZero() {
+			t.ewma = max
+		} else {
+			alpha := 1 - math.Exp(-float64(now.Sub(t.last))/float64(t.tau))
+			t.ewma += alpha * (max - t.ewma)
+		}
+		t.last = now
+	}
+
+	if t.last.IsZero() {
+		return nil
+	}
+	return &ThermalStats{
+		MaxCelsius:      t.ewma,
+		HeadroomCelsius: math.Max(0, t.critical-t.ewma),
+	}
+}
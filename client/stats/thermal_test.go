@@ -0,0 +1,36 @@
+package stats
+
+import (
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/require"
+)
+
+func TestThermalTracker_Update(t *testing.T) {
+	tracker := newThermalTracker(0, 0)
+	now := time.Now()
+
+	// Nothing is reported before the first reading.
+	require.Nil(t, tracker.update(nil, now))
+
+	stats := tracker.update([]*TemperatureStats{
+		{Sensor: "TC0P", Celsius: 60},
+		{Sensor: "TG0P", Celsius: 70},
+	}, now)
+	require.Equal(t, 70.0, stats.MaxCelsius)
+	require.Equal(t, 30.0, stats.HeadroomCelsius)
+
+	// After one time constant the average has moved 1-1/e of the way.
+	now = now.Add(defaultThermalTimeConstant)
+	stats = tracker.update([]*TemperatureStats{{Sensor: "TC0P", Celsius: 100}}, now)
+	require.InDelta(t, 70+30*(1-1/2.718281828), stats.MaxCelsius, 0.01)
+
+	// Missing readings leave the average unchanged.
+	require.Equal(t, stats, tracker.update(nil, now.Add(time.Second)))
+
+	// Headroom does not go negative.
+	now = now.Add(100 * defaultThermalTimeConstant)
+	stats = tracker.update([]*TemperatureStats{{Sensor: "TC0P", Celsius: 110}}, now)
+	require.Zero(t, stats.HeadroomCelsius)
+}
@@ -257,17 +257,52 @@ func (cs *CpuStats) Add(other *CpuStats) {
 	cs.Measured = joinStringSet(cs.Measured, other.Measured)
 }
 
+// PowerStats holds the power drawn by a workload, estimated from its share of
+// the host's CPU usage
+type PowerStats struct {
+	// Sensor is the host power sensor the estimate is attributed from
+	Sensor string
+
+	// Share is the fraction of the host's CPU usage, and so of the power
+	// read by Sensor, attributed to the workload
+	Share float64
+
+	// Watts is the estimated power drawn by the workload
+	Watts float64
+}
+
+func (ps *PowerStats) Add(other *PowerStats) {
+	if other == nil {
+		return
+	}
+
+	if ps.Sensor == "" {
+		ps.Sensor = other.Sensor
+	}
+	ps.Share += other.Share
+	ps.Watts += other.Watts
+}
+
 // ResourceUsage holds information related to cpu and memory stats
 type ResourceUsage struct {
 	MemoryStats *MemoryStats
 	CpuStats    *CpuStats
 	DeviceStats []*device.DeviceGroupStats
+
+	// PowerStats is nil when the host's power cannot be read
+	PowerStats *PowerStats
 }
 
 func (ru *ResourceUsage) Add(other *ResourceUsage) {
 	ru.MemoryStats.Add(other.MemoryStats)
 	ru.CpuStats.Add(other.CpuStats)
 	ru.DeviceStats = append(ru.DeviceStats, other.DeviceStats...)
+	if other.PowerStats != nil {
+		if ru.PowerStats == nil {
+			ru.PowerStats = &PowerStats{}
+		}
+		ru.PowerStats.Add(other.PowerStats)
+	}
 }
 
 // TaskResourceUsage holds aggregated resource usage of all processes in a Task
@@ -0,0 +1,20 @@
+package main
+
+import (
+	"context"
+
+	log "github.com/hashicorp/go-hclog"
+
+	"github.com/hashicorp/nomad/devices/sensor/smc"
+	"github.com/hashicorp/nomad/plugins"
+)
+
+func main() {
+	// Serve the plugin
+	plugins.ServeCtx(factory)
+}
+
+// factory returns a new instance of the SMC sensor plugin
+func factory(ctx context.Context, log log.Logger) interface{} {
+	return smc.NewSMCDevice(ctx, log)
+}
@@ -0,0 +1,254 @@
+package smc
+
+import (
+	"context"
+	"fmt"
+	"sync"
+	"time"
+
+	log "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/helper/pluginutils/loader"
+	"github.com/hashicorp/nomad/lib/darwin"
+	"github.com/hashicorp/nomad/plugins/base"
+	"github.com/hashicorp/nomad/plugins/device"
+	"github.com/hashicorp/nomad/plugins/shared/hclspec"
+)
+
+const (
+	// pluginName is the name of the plugin
+	pluginName = "apple-smc"
+
+	// vendor is the vendor providing the devices
+	vendor = "apple"
+
+	// deviceType is the type of device being returned
+	deviceType = "sensor"
+
+	// deviceName is the name of the single device group and device exposed
+	// by the plugin: the host's System Management Controller.
+	deviceName = "smc"
+)
+
+var (
+	// PluginID is the SMC plugin metadata registered in the plugin catalog.
+	PluginID = loader.PluginID{
+		Name:       pluginName,
+		PluginType: base.PluginTypeDevice,
+	}
+
+	// PluginConfig is the SMC factory function registered in the plugin
+	// catalog.
+	PluginConfig = &loader.InternalPluginConfig{
+		Factory: func(ctx context.Context, l log.Logger) interface{} { return NewSMCDevice(ctx, l) },
+	}
+
+	// pluginInfo describes the plugin
+	pluginInfo = &base.PluginInfoResponse{
+		Type:              base.PluginTypeDevice,
+		PluginApiVersions: []string{device.ApiVersion010},
+		PluginVersion:     "0.1.0",
+		Name:              pluginName,
+	}
+
+	// configSpec is the specification of the plugin's configuration
+	configSpec = hclspec.NewObject(map[string]*hclspec.Spec{
+		"enabled": hclspec.NewDefault(
+			hclspec.NewAttr("enabled", "bool", false),
+			hclspec.NewLiteral("false"),
+		),
+		"stats_period": hclspec.NewDefault(
+			hclspec.NewAttr("stats_period", "string", false),
+			hclspec.NewLiteral("\"\""),
+		),
+	})
+)
+
+// Config contains configuration information for the plugin.
+type Config struct {
+	Enabled     bool   `codec:"enabled"`
+	StatsPeriod string `codec:"stats_period"`
+}
+
+// SensorClient reads the host's temperature sensors. It is implemented on
+// top of lib/darwin and replaced in tests.
+type SensorClient interface {
+	// Sensors returns the temperature sensors present on the host.
+	Sensors() ([]darwin.Sensor, error)
+
+	// NewBatch prepares sensors to be read together, see darwin.NewBatch.
+	NewBatch(sensors []darwin.Sensor) (SensorBatch, error)
+}
+
+// SensorBatch is a fixed set of sensors that are read together.
+type SensorBatch interface {
+	// Read reads every sensor of the batch with a single native call and
+	// stores the readings into values. ok[i] reports whether the i-th sensor
+	// was read successfully.
+	Read(values []float64, ok []bool) error
+
+	// Free releases the batch.
+	Free()
+}
+
+// smcClient is the SensorClient backed by lib/darwin. It keeps a connection
+// open for the life of the plugin.
+type smcClient struct {
+	smc *darwin.SMC
+}
+
+func newSMCClient() (*smcClient, error) {
+	smc, err := darwin.Open()
+	if err != nil {
+		return nil, err
+	}
+	return &smcClient{smc: smc}, nil
+}
+
+func (c *smcClient) Sensors() ([]darwin.Sensor, error) {
+	return darwin.TemperatureSensors()
+}
+
+func (c *smcClient) NewBatch(sensors []darwin.Sensor) (SensorBatch, error) {
+	batch, err := darwin.NewBatch(sensors)
+	if err != nil {
+		return nil, err
+	}
+	return &smcBatch{smc: c.smc, batch: batch}, nil
+}
+
+// smcBatch is the SensorBatch backed by a darwin.Batch, whose readings are
+// kept outside the Go heap so that reading it allocates nothing.
+type smcBatch struct {
+	smc   *darwin.SMC
+	batch *darwin.Batch
+}
+
+func (b *smcBatch) Read(values []float64, ok []bool) error {
+	if err := b.smc.ReadBatch(b.batch); err != nil {
+		return err
+	}
+	for i := range values {
+		values[i], ok[i] = b.batch.Value(i)
+	}
+	return nil
+}
+
+func (b *smcBatch) Free() {
+	b.batch.Free()
+}
+
+// SMCDevice contains all plugin specific data
+type SMCDevice struct {
+	// enabled indicates whether the plugin should be enabled
+	enabled bool
+
+	// statsPeriod overrides the stats interval requested by the client when
+	// set.
+	statsPeriod time.Duration
+
+	// client is used to read the sensors
+	client SensorClient
+
+	// initErr holds an error retrieved while opening the SMC
+	initErr error
+
+	// sensors is the set of detected temperature sensors
+	sensors    []darwin.Sensor
+	sensorLock sync.RWMutex
+
+	logger log.Logger
+}
+
+// NewSMCDevice returns a new SMC device plugin.
+func NewSMCDevice(_ context.Context, log log.Logger) *SMCDevice {
+	logger := log.Named(pluginName)
+
+	d := &SMCDevice{logger: logger}
+	client, err := newSMCClient()
+	if err != nil {
+		if err != darwin.ErrNotSupported {
+			logger.Error("unable to open the SMC", "reason", err)
+		}
+		d.initErr = err
+	} else {
+		d.client = client
+	}
+	return d
+}
+
+// PluginInfo returns information describing the plugin.
+func (d *SMCDevice) PluginInfo() (*base.PluginInfoResponse, error) {
+	return pluginInfo, nil
+}
+
+// ConfigSchema returns the plugins configuration schema.
+func (d *SMCDevice) ConfigSchema() (*hclspec.Spec, error) {
+	return configSpec, nil
+}
+
+// SetConfig is used to set the configuration of the plugin.
+func (d *SMCDevice) SetConfig(cfg *base.Config) error {
+	var config Config
+	if len(cfg.PluginConfig) != 0 {
+		if err := base.MsgPackDecode(cfg.PluginConfig, &config); err != nil {
+			return err
+		}
+	}
+
+	d.enabled = config.Enabled
+
+	if config.StatsPeriod != "" {
+		period, err := time.ParseDuration(config.StatsPeriod)
+		if err != nil {
+			return fmt.Errorf("failed to parse stats period %q: %v", config.StatsPeriod, err)
+		}
+		d.statsPeriod = period
+	}
+
+	return nil
+}
+
+// Fingerprint streams the SMC as a single device. Sensors are discovered once
+// since the set of SMC keys cannot change while the host is booted.
+func (d *SMCDevice) Fingerprint(ctx context.Context) (<-chan *device.FingerprintResponse, error) {
+	if !d.enabled {
+		return nil, device.ErrPluginDisabled
+	}
+
+	outCh := make(chan *device.FingerprintResponse)
+	go d.fingerprint(ctx, outCh)
+	return outCh, nil
+}
+
+// Reserve returns an empty reservation: sensors are read by the plugin and
+// there is nothing to mount into a task.
+func (d *SMCDevice) Reserve(deviceIDs []string) (*device.ContainerReservation, error) {
+	if len(deviceIDs) == 0 {
+		return &device.ContainerReservation{}, nil
+	}
+	if !d.enabled {
+		return nil, device.ErrPluginDisabled
+	}
+
+	for _, id := range deviceIDs {
+		if id != deviceName {
+			return nil, fmt.Errorf("unknown device ID: %s", id)
+		}
+	}
+	return &device.ContainerReservation{}, nil
+}
+
+// Stats streams the temperature of every detected sensor.
+func (d *SMCDevice) Stats(ctx context.Context, interval time.Duration) (<-chan *device.StatsResponse, error) {
+	if !d.enabled {
+		return nil, device.ErrPluginDisabled
+	}
+
+	if d.statsPeriod != 0 {
+		interval = d.statsPeriod
+	}
+
+	outCh := make(chan *device.StatsResponse)
+	go d.stats(ctx, outCh, interval)
+	return outCh, nil
+}
@@ -0,0 +1,31 @@
+package smc
+
+import (
+	"testing"
+
+	hclog "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/plugins/device"
+	"github.com/stretchr/testify/require"
+)
+
+func TestReserve(t *testing.T) {
+	d := &SMCDevice{
+		logger:  hclog.NewNullLogger(),
+		enabled: true,
+	}
+
+	reservation, err := d.Reserve(nil)
+	require.NoError(t, err)
+	require.Equal(t, &device.ContainerReservation{}, reservation)
+
+	reservation, err = d.Reserve([]string{deviceName})
+	require.NoError(t, err)
+	require.Equal(t, &device.ContainerReservation{}, reservation)
+
+	_, err = d.Reserve([]string{"gpu0"})
+	require.Error(t, err)
+
+	d.enabled = false
+	_, err = d.Reserve([]string{deviceName})
+	require.Equal(t, device.ErrPluginDisabled, err)
+}
@@ -0,0 +1,65 @@
+package smc
+
+import (
+	"context"
+
+	"github.com/hashicorp/nomad/helper"
+	"github.com/hashicorp/nomad/plugins/device"
+	"github.com/hashicorp/nomad/plugins/shared/structs"
+)
+
+const (
+	// SensorCountAttr is the number of temperature sensors found
+	SensorCountAttr = "sensor_count"
+)
+
+// fingerprint is the long running goroutine that detects the SMC sensors. The
+// sensors are fixed while the host is booted, so it only reports once and
+// then waits for the context to be cancelled.
+func (d *SMCDevice) fingerprint(ctx context.Context, devices chan<- *device.FingerprintResponse) {
+	defer close(devices)
+
+	if d.initErr != nil {
+		// Just close the channel to let the client know there is no SMC
+		return
+	}
+
+	sensors, err := d.client.Sensors()
+	if err != nil {
+		d.logger.Error("failed to discover SMC sensors", "error", err)
+		devices <- device.NewFingerprintError(err)
+		return
+	}
+
+	d.sensorLock.Lock()
+	d.sensors = sensors
+	d.sensorLock.Unlock()
+
+	if len(sensors) == 0 {
+		devices <- device.NewFingerprint()
+	} else {
+		devices <- device.NewFingerprint(deviceGroup(len(sensors)))
+	}
+
+	<-ctx.Done()
+}
+
+// deviceGroup returns the group holding the single SMC device.
+func deviceGroup(sensorCount int) *device.DeviceGroup {
+	return &device.DeviceGroup{
+		Vendor: vendor,
+		Type:   deviceType,
+		Name:   deviceName,
+		Devices: []*device.Device{
+			{
+				ID:      deviceName,
+				Healthy: true,
+			},
+		},
+		Attributes: map[string]*structs.Attribute{
+			SensorCountAttr: {
+				Int: helper.Int64ToPtr(int64(sensorCount)),
+			},
+		},
+	}
+}
@@ -0,0 +1,144 @@
+package smc
+
+import (
+	"context"
+	"time"
+
+	"github.com/hashicorp/nomad/helper"
+	"github.com/hashicorp/nomad/lib/darwin"
+	"github.com/hashicorp/nomad/plugins/device"
+	"github.com/hashicorp/nomad/plugins/shared/structs"
+)
+
+const (
+	// Attribute names for reporting stats output
+	TemperatureUnit    = "C" // Celsius degrees
+	TemperatureDesc    = "Temperature reported by the sensor"
+	MaxTemperatureDesc = "Temperature of the hottest sensor"
+)
+
+// stats is the long running goroutine that streams sensor temperatures. All
+// sensors are read with a single batched call per interval, so consumers of
+// the stats never poll the SMC themselves. The batch and the buffers it is
+// read into are kept for the life of the goroutine.
+func (d *SMCDevice) stats(ctx context.Context, stats chan<- *device.StatsResponse, interval time.Duration) {
+	defer close(stats)
+
+	if d.initErr != nil {
+		return
+	}
+
+	var batch SensorBatch
+	var values []float64
+	var ok []bool
+	defer func() {
+		if batch != nil {
+			batch.Free()
+		}
+	}()
+
+	// Create a timer that will fire immediately for the first detection
+	ticker := time.NewTimer(0)
+
+	for {
+		select {
+		case <-ctx.Done():
+			return
+		case <-ticker.C:
+			ticker.Reset(interval)
+		}
+
+		d.sensorLock.RLock()
+		sensors := d.sensors
+		d.sensorLock.RUnlock()
+
+		if len(sensors) == 0 {
+			continue
+		}
+		if batch == nil || len(values) != len(sensors) {
+			if batch != nil {
+				batch.Free()
+				batch = nil
+			}
+
+			b, err := d.client.NewBatch(sensors)
+			if err != nil {
+				d.logger.Error("failed to prepare SMC sensors", "error", err)
+				stats <- &device.StatsResponse{
+					Error: err,
+				}
+				continue
+			}
+			batch = b
+			values = make([]float64, len(sensors))
+			ok = make([]bool, len(sensors))
+		}
+
+		d.writeStatsToChannel(stats, batch, sensors, values, ok, time.Now())
+	}
+}
+
+// writeStatsToChannel reads the batch of sensors and sends their temperatures
+// as the stats of the SMC device.
+func (d *SMCDevice) writeStatsToChannel(stats chan<- *device.StatsResponse, batch SensorBatch,
+	sensors []darwin.Sensor, values []float64, ok []bool, timestamp time.Time) {
+
+	if err := batch.Read(values, ok); err != nil {
+		d.logger.Error("failed to read SMC sensors", "error", err)
+		stats <- &device.StatsResponse{
+			Error: err,
+		}
+		return
+	}
+
+	stats <- &device.StatsResponse{
+		Groups: []*device.DeviceGroupStats{
+			{
+				Vendor: vendor,
+				Type:   deviceType,
+				Name:   deviceName,
+				InstanceStats: map[string]*device.DeviceStats{
+					deviceName: statsForSensors(sensors, values, ok, timestamp),
+				},
+			},
+		},
+	}
+}
+
+// statsForSensors builds the device stats for a set of readings, with the
+// hottest sensor as the summary. Sensors that could not be read are left out.
+func statsForSensors(sensors []darwin.Sensor, values []float64, ok []bool, timestamp time.Time) *device.DeviceStats {
+	attrs := make(map[string]*structs.StatValue, len(sensors))
+	var max *float64
+	for i, sensor := range sensors {
+		if !ok[i] {
+			continue
+		}
+
+		value := values[i]
+		attrs[sensor.Key] = &structs.StatValue{
+			Unit:              TemperatureUnit,
+			Desc:              TemperatureDesc,
+			FloatNumeratorVal: helper.Float64ToPtr(value),
+		}
+		if max == nil || value > *max {
+			max = helper.Float64ToPtr(value)
+		}
+	}
+
+	summary := &structs.StatValue{
+		Unit: TemperatureUnit,
+		Desc: MaxTemperatureDesc,
+	}
+	if max != nil {
+		summary.FloatNumeratorVal = max
+	} else {
+		summary.StringVal = helper.StringToPtr("N/A")
+	}
+
+	return &device.DeviceStats{
+		Summary:   summary,
+		Stats:     &structs.StatObject{Attributes: attrs},
+		Timestamp: timestamp,
+	}
+}
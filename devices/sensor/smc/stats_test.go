@@ -0,0 +1,146 @@
+package smc
+
+import (
+	"context"
+	"errors"
+	"testing"
+	"time"
+
+	hclog "github.com/hashicorp/go-hclog"
+	"github.com/hashicorp/nomad/lib/darwin"
+	"github.com/hashicorp/nomad/plugins/device"
+	"github.com/stretchr/testify/require"
+)
+
+type MockSensorClient struct {
+	SensorsError    error
+	SensorsReturned []darwin.Sensor
+
+	ReadError  error
+	ReadValues []float64
+	ReadOK     []bool
+
+	Batches []*MockSensorBatch
+}
+
+func (c *MockSensorClient) Sensors() ([]darwin.Sensor, error) {
+	return c.SensorsReturned, c.SensorsError
+}
+
+func (c *MockSensorClient) NewBatch(sensors []darwin.Sensor) (SensorBatch, error) {
+	batch := &MockSensorBatch{client: c}
+	c.Batches = append(c.Batches, batch)
+	return batch, nil
+}
+
+type MockSensorBatch struct {
+	client *MockSensorClient
+	freed  bool
+}
+
+func (b *MockSensorBatch) Read(values []float64, ok []bool) error {
+	copy(values, b.client.ReadValues)
+	copy(ok, b.client.ReadOK)
+	return b.client.ReadError
+}
+
+func (b *MockSensorBatch) Free() {
+	b.freed = true
+}
+
+func TestStatsForSensors(t *testing.T) {
+	timestamp := time.Now()
+	sensors := []darwin.Sensor{{Key: "TC0P"}, {Key: "TG0P"}, {Key: "TA0P"}}
+
+	stats := statsForSensors(sensors, []float64{50.5, 61.0, 0}, []bool{true, true, false}, timestamp)
+	require.Equal(t, timestamp, stats.Timestamp)
+	require.Equal(t, 61.0, *stats.Summary.FloatNumeratorVal)
+	require.Len(t, stats.Stats.Attributes, 2)
+	require.Equal(t, 50.5, *stats.Stats.Attributes["TC0P"].FloatNumeratorVal)
+	require.Equal(t, 61.0, *stats.Stats.Attributes["TG0P"].FloatNumeratorVal)
+	require.NotContains(t, stats.Stats.Attributes, "TA0P")
+
+	// With no readings the summary is reported as not available.
+	stats = statsForSensors(sensors, []float64{0, 0, 0}, []bool{false, false, false}, timestamp)
+	require.Nil(t, stats.Summary.FloatNumeratorVal)
+	require.Equal(t, "N/A", *stats.Summary.StringVal)
+	require.Empty(t, stats.Stats.Attributes)
+}
+
+func TestStats_ReusesBatch(t *testing.T) {
+	client := &MockSensorClient{
+		ReadValues: []float64{50.5, 61.0},
+		ReadOK:     []bool{true, true},
+	}
+	d := &SMCDevice{
+		client:  client,
+		sensors: []darwin.Sensor{{Key: "TC0P"}, {Key: "TG0P"}},
+		logger:  hclog.NewNullLogger(),
+	}
+
+	ctx, cancel := context.WithCancel(context.Background())
+	channel := make(chan *device.StatsResponse)
+	go d.stats(ctx, channel, time.Millisecond)
+
+	for i := 0; i < 3; i++ {
+		require.NoError(t, (<-channel).Error)
+	}
+	cancel()
+	for range channel {
+	}
+
+	// The sensors are read through one batch, freed once stats returns.
+	require.Len(t, client.Batches, 1)
+	require.True(t, client.Batches[0].freed)
+}
+
+func TestWriteStatsToChannel(t *testing.T) {
+	sensors := []darwin.Sensor{{Key: "TC0P"}, {Key: "TG0P"}}
+
+	for _, testCase := range []struct {
+		Name          string
+		Client        *MockSensorClient
+		ExpectedError error
+	}{
+		{
+			Name: "Sensors are read",
+			Client: &MockSensorClient{
+				ReadValues: []float64{50.5, 61.0},
+				ReadOK:     []bool{true, true},
+			},
+		},
+		{
+			Name: "Read fails",
+			Client: &MockSensorClient{
+				ReadError: errors.New(""),
+			},
+			ExpectedError: errors.New(""),
+		},
+	} {
+		t.Run(testCase.Name, func(t *testing.T) {
+			d := &SMCDevice{
+				client: testCase.Client,
+				logger: hclog.NewNullLogger(),
+			}
+
+			channel := make(chan *device.StatsResponse, 1)
+			batch, err := d.client.NewBatch(sensors)
+			require.NoError(t, err)
+			d.writeStatsToChannel(channel, batch, sensors, make([]float64, 2), make([]bool, 2), time.Now())
+			actual := <-channel
+
+			require.Equal(t, testCase.ExpectedError, actual.Error)
+			if testCase.ExpectedError != nil {
+				return
+			}
+
+			require.Len(t, actual.Groups, 1)
+			group := actual.Groups[0]
+			require.Equal(t, vendor, group.Vendor)
+			require.Equal(t, deviceType, group.Type)
+			require.Equal(t, deviceName, group.Name)
+			require.Contains(t, group.InstanceStats, deviceName)
+			require.Len(t, group.InstanceStats[deviceName].Stats.Attributes, 2)
+		})
+	}
+}
@@ -0,0 +1,14 @@
+// +build !nosmc
+
+package catalog
+
+import (
+	"github.com/hashicorp/nomad/devices/sensor/smc"
+)
+
+// This file is where all builtin plugins should be registered in the catalog.
+// Plugins with build restrictions should be placed in the appropriate
+// register_XXX.go file.
+func init() {
+	Register(smc.PluginID, smc.PluginConfig)
+}
@@ -0,0 +1,5 @@
+// +build darwin,cgo
+
+// cgo only compiles C files that live in the package directory, so the
+// aggregate implementation is pulled in from include/ here.
+#include "aggregate.c"
@@ -0,0 +1,104 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include <stdlib.h>
+// #include "smc.h"
+import "C"
+
+import (
+	"fmt"
+	"sync"
+	"unsafe"
+)
+
+// maxBatchSize bounds the length of the Go view of a batch's C array.
+const maxBatchSize = 1 << 20
+
+// Batch is a fixed set of sensors that are read together. Its keys and
+// results live in a single array allocated outside the Go heap when the batch
+// is created, so a read is one cgo call that fills the array in place and
+// allocates nothing.
+type Batch struct {
+	l        sync.Mutex
+	ptr      *C.smc_reading_t
+	readings []C.smc_reading_t // view of ptr.
+}
+
+// NewBatch returns a batch that reads sensors, which must be released with
+// Free.
+func NewBatch(sensors []Sensor) (*Batch, error) {
+	if len(sensors) == 0 || len(sensors) > maxBatchSize {
+		return nil, fmt.Errorf("smc: invalid batch size %d", len(sensors))
+	}
+
+	ptr := (*C.smc_reading_t)(C.calloc(C.size_t(len(sensors)), C.sizeof_smc_reading_t))
+	if ptr == nil {
+		return nil, ErrNoMemory
+	}
+
+	b := &Batch{
+		ptr:      ptr,
+		readings: (*[maxBatchSize]C.smc_reading_t)(unsafe.Pointer(ptr))[:len(sensors):len(sensors)],
+	}
+	for i, sensor := range sensors {
+		b.readings[i].key = C.smc_key_t(sensor.key)
+		b.readings[i].status = C.SMC_ERR_KEY_MISSING
+	}
+	return b, nil
+}
+
+// Free releases the memory of the batch.
+func (b *Batch) Free() {
+	b.l.Lock()
+	defer b.l.Unlock()
+
+	if b.ptr == nil {
+		return
+	}
+	C.free(unsafe.Pointer(b.ptr))
+	b.ptr = nil
+	b.readings = nil
+}
+
+// Len returns the number of sensors in the batch, or 0 once it is freed.
+func (b *Batch) Len() int {
+	b.l.Lock()
+	defer b.l.Unlock()
+	return len(b.readings)
+}
+
+// Value returns the last reading of the i-th sensor of the batch and whether
+// it was read successfully. It is safe to call while another goroutine reads
+// the batch, and reports a failed read once the batch is freed.
+func (b *Batch) Value(i int) (float64, bool) {
+	b.l.Lock()
+	defer b.l.Unlock()
+
+	if b.ptr == nil {
+		return 0, false
+	}
+	r := &b.readings[i]
+	return float64(r.value), r.status == C.SMC_OK
+}
+
+// ReadBatch reads every sensor of b with a single native call, updating the
+// values returned by b.Value.
+func (s *SMC) ReadBatch(b *Batch) error {
+	b.l.Lock()
+	defer b.l.Unlock()
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.handle == nil {
+		return fmt.Errorf("smc: connection is closed")
+	}
+	if b.ptr == nil {
+		return fmt.Errorf("smc: batch is freed")
+	}
+
+	if ret := C.read_smc_readings(s.handle, b.ptr, C.int(len(b.readings))); ret != C.SMC_OK {
+		return Error(ret)
+	}
+	return nil
+}
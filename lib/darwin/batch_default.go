@@ -0,0 +1,30 @@
+// +build !darwin !cgo
+
+package darwin
+
+// Batch is a fixed set of sensors that are read together. It is not available
+// on this platform.
+type Batch struct{}
+
+// NewBatch returns ErrNotSupported on this platform.
+func NewBatch(sensors []Sensor) (*Batch, error) {
+	return nil, ErrNotSupported
+}
+
+// Free is a no-op on this platform.
+func (b *Batch) Free() {}
+
+// Len always returns 0 on this platform.
+func (b *Batch) Len() int {
+	return 0
+}
+
+// Value always returns false on this platform.
+func (b *Batch) Value(i int) (float64, bool) {
+	return 0, false
+}
+
+// ReadBatch returns ErrNotSupported on this platform.
+func (s *SMC) ReadBatch(b *Batch) error {
+	return ErrNotSupported
+}
@@ -0,0 +1,67 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include <stdlib.h>
+// #include "smc.h"
+import "C"
+
+import "unsafe"
+
+// The helpers below give the benchmarks in smc_bench_test.go access to the
+// native read path, since test files cannot use cgo.
+
+// ioCalls returns the number of IOKit calls made through s since it was
+// opened.
+func (s *SMC) ioCalls() uint64 {
+	s.l.Lock()
+	defer s.l.Unlock()
+	return uint64(C.smc_io_calls(s.handle))
+}
+
+// flushKeyInfo drops the key info cached by s, so that the next read of each
+// key pays for kSMCGetKeyInfo again.
+func (s *SMC) flushKeyInfo() {
+	s.l.Lock()
+	defer s.l.Unlock()
+	C.smc_flush_key_info(s.handle)
+}
+
+// benchKey is a key resolved up front so that benchmarks measure the native
+// read rather than converting Go strings.
+type benchKey struct {
+	name *C.char
+	key  C.smc_key_t
+}
+
+func newBenchKeys(names []string) []benchKey {
+	keys := make([]benchKey, len(names))
+	for i, name := range names {
+		keys[i] = benchKey{
+			name: C.CString(name),
+			key:  C.smc_key_t(encodeKey(name)),
+		}
+	}
+	return keys
+}
+
+func freeBenchKeys(keys []benchKey) {
+	for _, k := range keys {
+		C.free(unsafe.Pointer(k.name))
+	}
+}
+
+// getTemperature reads k through get_temperature, which encodes the key name
+// on every call.
+func (s *SMC) getTemperature(k benchKey) float64 {
+	s.l.Lock()
+	defer s.l.Unlock()
+	return float64(C.get_temperature(s.handle, k.name))
+}
+
+// getTemperatureKey reads k through get_temperature_key.
+func (s *SMC) getTemperatureKey(k benchKey) float64 {
+	s.l.Lock()
+	defer s.l.Unlock()
+	return float64(C.get_temperature_key(s.handle, k.key))
+}
@@ -0,0 +1,138 @@
+package darwin
+
+import (
+	"encoding/json"
+	"fmt"
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"sync"
+)
+
+// discoveryCacheVersion is bumped whenever the format of the discovery cache
+// or the way sensors are discovered changes, so that older caches are
+// rediscovered.
+const discoveryCacheVersion = 1
+
+var (
+	cacheLock sync.Mutex
+	cachePath string
+)
+
+// SetDiscoveryCache sets the file the sensors found by Sensors are saved to.
+// Later processes on the same hardware model and OS build load them from it
+// instead of enumerating the SMC key space again. It only takes effect if
+// called before discovery starts; an empty path disables the cache.
+func SetDiscoveryCache(path string) {
+	cacheLock.Lock()
+	defer cacheLock.Unlock()
+	cachePath = path
+}
+
+func discoveryCachePath() string {
+	cacheLock.Lock()
+	defer cacheLock.Unlock()
+	return cachePath
+}
+
+// platformIdentity identifies the set of keys an SMC exposes: the same model
+// running the same OS build has the same keys.
+type platformIdentity struct {
+	Model   string
+	OSBuild string
+	Backend Backend
+}
+
+// discoveryCache is the file written by saveDiscoveryCache.
+type discoveryCache struct {
+	Version  int
+	Identity platformIdentity
+	Sensors  []cachedSensor
+}
+
+type cachedSensor struct {
+	Key  string
+	Kind SensorKind
+	Type string
+	Size uint32
+}
+
+// loadDiscoveryCache returns the SMC sensors saved at path, or false if there
+// are none or they were discovered on a different platform.
+func loadDiscoveryCache(path string, identity platformIdentity) ([]Sensor, bool) {
+	data, err := ioutil.ReadFile(path)
+	if err != nil {
+		return nil, false
+	}
+
+	var cache discoveryCache
+	if err := json.Unmarshal(data, &cache); err != nil {
+		return nil, false
+	}
+	if cache.Version != discoveryCacheVersion || cache.Identity != identity {
+		return nil, false
+	}
+
+	sensors := make([]Sensor, 0, len(cache.Sensors))
+	for _, cached := range cache.Sensors {
+		key := encodeKey(cached.Key)
+		if key == 0 || key&hidKeyFlag != 0 {
+			return nil, false
+		}
+		sensors = append(sensors, Sensor{
+			Key:  cached.Key,
+			Kind: cached.Kind,
+			Type: cached.Type,
+			Size: cached.Size,
+			key:  key,
+		})
+	}
+	return sensors, true
+}
+
+// saveDiscoveryCache saves the SMC sensors among sensors to path. HID sensors
+// are not saved since their keys are only valid within a process; they are
+// cheap to find again.
+func saveDiscoveryCache(path string, identity platformIdentity, sensors []Sensor) error {
+	cache := discoveryCache{
+		Version:  discoveryCacheVersion,
+		Identity: identity,
+		Sensors:  make([]cachedSensor, 0, len(sensors)),
+	}
+	for _, sensor := range sensors {
+		if sensor.key&hidKeyFlag != 0 {
+			continue
+		}
+		cache.Sensors = append(cache.Sensors, cachedSensor{
+			Key:  sensor.Key,
+			Kind: sensor.Kind,
+			Type: sensor.Type,
+			Size: sensor.Size,
+		})
+	}
+
+	data, err := json.Marshal(&cache)
+	if err != nil {
+		return err
+	}
+
+	// Write to a temporary file first so that a crash never leaves a
+	// truncated cache behind.
+	tmp, err := ioutil.TempFile(filepath.Dir(path), filepath.Base(path)+".tmp")
+	if err != nil {
+		return err
+	}
+	defer os.Remove(tmp.Name())
+
+	if _, err := tmp.Write(data); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err := tmp.Close(); err != nil {
+		return err
+	}
+	if err := os.Rename(tmp.Name(), path); err != nil {
+		return fmt.Errorf("failed to replace sensor discovery cache: %w", err)
+	}
+	return nil
+}
@@ -0,0 +1,51 @@
+package darwin
+
+import (
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/stretchr/testify/require"
+)
+
+func TestDiscoveryCache(t *testing.T) {
+	dir, err := ioutil.TempDir("", "nomad")
+	require.NoError(t, err)
+	defer os.RemoveAll(dir)
+
+	path := filepath.Join(dir, "sensors.json")
+	identity := platformIdentity{Model: "MacBookPro18,3", OSBuild: "22G91", Backend: BackendHID}
+	sensors := []Sensor{
+		{Key: "PMU tdie1", Kind: KindTemperature, Type: "hid ", Size: 8, key: hidKeyFlag},
+		{Key: "F0Ac", Kind: KindFan, Type: "fpe2", Size: 2, key: encodeKey("F0Ac")},
+		{Key: "PSTR", Kind: KindPower, Type: "sp96", Size: 2, key: encodeKey("PSTR")},
+	}
+
+	// Nothing is cached yet.
+	_, ok := loadDiscoveryCache(path, identity)
+	require.False(t, ok)
+
+	require.NoError(t, saveDiscoveryCache(path, identity, sensors))
+
+	// HID sensors are left out since their keys do not outlive the process.
+	cached, ok := loadDiscoveryCache(path, identity)
+	require.True(t, ok)
+	require.Equal(t, sensors[1:], cached)
+
+	// Another model or OS build must rediscover.
+	other := identity
+	other.OSBuild = "23A344"
+	_, ok = loadDiscoveryCache(path, other)
+	require.False(t, ok)
+
+	other = identity
+	other.Model = "Mac14,2"
+	_, ok = loadDiscoveryCache(path, other)
+	require.False(t, ok)
+
+	// A corrupt cache is ignored.
+	require.NoError(t, ioutil.WriteFile(path, []byte("{"), 0600))
+	_, ok = loadDiscoveryCache(path, identity)
+	require.False(t, ok)
+}
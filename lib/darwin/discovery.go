@@ -0,0 +1,116 @@
+package darwin
+
+import (
+	"sync"
+	"time"
+)
+
+const (
+	// discoverRetryMin and discoverRetryMax bound the time waited after a
+	// failed discovery before it is attempted again. The wait doubles with
+	// every consecutive failure.
+	discoverRetryMin = 15 * time.Second
+	discoverRetryMax = 5 * time.Minute
+)
+
+// discovery memoizes the sensors found by discover. Only a successful
+// discovery, or one that finds the platform unsupported, is kept for the
+// life of the process; after a failure, such as a transient IOKit error, the
+// failure is returned until a backoff has passed and discovery is then
+// attempted again.
+type discovery struct {
+	discover func() ([]Sensor, error)
+	now      func() time.Time
+	retryMin time.Duration
+	retryMax time.Duration
+
+	// run serializes attempts, so that callers arriving during one wait for
+	// its outcome rather than starting another.
+	run sync.Mutex
+
+	// l guards the outcome of the last attempt. done is set once it is
+	// final, and retryAt is when a failed attempt may be retried. running is
+	// set while Start has an attempt in progress in the background.
+	l        sync.Mutex
+	done     bool
+	sensors  []Sensor
+	err      error
+	failures int
+	retryAt  time.Time
+	running  bool
+}
+
+func newDiscovery(discover func() ([]Sensor, error)) *discovery {
+	return &discovery{
+		discover: discover,
+		now:      time.Now,
+		retryMin: discoverRetryMin,
+		retryMax: discoverRetryMax,
+	}
+}
+
+// cached returns the outcome of the last attempt, and whether it is current,
+// in which case no other attempt should be made yet. d.l must be held.
+func (d *discovery) cached() (sensors []Sensor, current bool, err error) {
+	if d.done || (d.err != nil && d.now().Before(d.retryAt)) {
+		return d.sensors, true, d.err
+	}
+	return nil, false, nil
+}
+
+// Sensors returns the discovered sensors, discovering them first unless the
+// outcome of an earlier attempt is still current.
+func (d *discovery) Sensors() ([]Sensor, error) {
+	d.run.Lock()
+	defer d.run.Unlock()
+
+	d.l.Lock()
+	sensors, current, err := d.cached()
+	d.l.Unlock()
+	if current {
+		return sensors, err
+	}
+
+	sensors, err = d.discover()
+
+	d.l.Lock()
+	defer d.l.Unlock()
+	d.sensors, d.err = sensors, err
+	if err == nil || err == ErrNotSupported {
+		d.done = true
+		return sensors, err
+	}
+
+	backoff := d.retryMin << d.failures
+	if backoff <= 0 || backoff > d.retryMax {
+		backoff = d.retryMax
+	} else {
+		d.failures++
+	}
+	d.retryAt = d.now().Add(backoff)
+	return sensors, err
+}
+
+// Start returns the outcome of Sensors without waiting for it. Unless the
+// outcome of an earlier attempt is current, it starts an attempt in the
+// background, if none is in progress, and returns pending until that attempt
+// has completed.
+func (d *discovery) Start() (sensors []Sensor, pending bool, err error) {
+	d.l.Lock()
+	defer d.l.Unlock()
+
+	if sensors, current, err := d.cached(); current {
+		return sensors, false, err
+	}
+	if !d.running {
+		d.running = true
+		go func() {
+			d.Sensors()
+
+			d.l.Lock()
+			d.running = false
+			d.l.Unlock()
+		}()
+	}
+	return nil, true, nil
+}
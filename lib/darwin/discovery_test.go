@@ -0,0 +1,143 @@
+package darwin
+
+import (
+	"errors"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/require"
+)
+
+// testDiscovery returns a discovery with a fake clock whose discover returns
+// the results queued in results, counting its calls in calls.
+func testDiscovery(results *[]error, calls *int) (*discovery, *time.Time) {
+	now := time.Now()
+	d := newDiscovery(func() ([]Sensor, error) {
+		*calls++
+		err := (*results)[0]
+		*results = (*results)[1:]
+		if err != nil {
+			return nil, err
+		}
+		return []Sensor{{Key: "TC0P"}}, nil
+	})
+	d.now = func() time.Time { return now }
+	return d, &now
+}
+
+func TestDiscovery_RetriesFailure(t *testing.T) {
+	failed := errors.New("smc: failed to enumerate keys")
+	results := []error{failed, failed, nil}
+	var calls int
+	d, now := testDiscovery(&results, &calls)
+
+	sensors, err := d.Sensors()
+	require.Equal(t, failed, err)
+	require.Empty(t, sensors)
+
+	// The failure is returned until the backoff has passed.
+	*now = now.Add(discoverRetryMin - time.Second)
+	_, err = d.Sensors()
+	require.Equal(t, failed, err)
+	require.Equal(t, 1, calls)
+
+	// The backoff doubles after each consecutive failure.
+	*now = now.Add(time.Second)
+	_, err = d.Sensors()
+	require.Equal(t, failed, err)
+	require.Equal(t, 2, calls)
+
+	*now = now.Add(2*discoverRetryMin - time.Second)
+	_, err = d.Sensors()
+	require.Equal(t, failed, err)
+	require.Equal(t, 2, calls)
+
+	// A successful discovery is kept for good.
+	*now = now.Add(time.Second)
+	sensors, err = d.Sensors()
+	require.NoError(t, err)
+	require.Len(t, sensors, 1)
+	require.Equal(t, 3, calls)
+
+	*now = now.Add(discoverRetryMax)
+	sensors, err = d.Sensors()
+	require.NoError(t, err)
+	require.Len(t, sensors, 1)
+	require.Equal(t, 3, calls)
+}
+
+func TestDiscovery_NotSupported(t *testing.T) {
+	results := []error{ErrNotSupported}
+	var calls int
+	d, now := testDiscovery(&results, &calls)
+
+	// A platform without sensors is not retried.
+	_, err := d.Sensors()
+	require.Equal(t, ErrNotSupported, err)
+
+	*now = now.Add(discoverRetryMax)
+	_, err = d.Sensors()
+	require.Equal(t, ErrNotSupported, err)
+	require.Equal(t, 1, calls)
+}
+
+func TestDiscovery_BackoffLimit(t *testing.T) {
+	failed := errors.New("smc: failed to open")
+	results := make([]error, 16)
+	for i := range results {
+		results[i] = failed
+	}
+	var calls int
+	d, now := testDiscovery(&results, &calls)
+
+	// The backoff stops growing at discoverRetryMax.
+	var backoff time.Duration
+	for i := 0; i < 16; i++ {
+		_, err := d.Sensors()
+		require.Equal(t, failed, err)
+		backoff = d.retryAt.Sub(*now)
+		require.True(t, backoff <= discoverRetryMax)
+		*now = d.retryAt
+	}
+	require.Equal(t, discoverRetryMax, backoff)
+	require.Equal(t, 16, calls)
+}
+
+func TestDiscovery_StartRetriesFailure(t *testing.T) {
+	failed := errors.New("smc: failed to enumerate keys")
+	results := []error{failed, nil}
+	var calls int
+	d, now := testDiscovery(&results, &calls)
+
+	// wait polls Start until the attempt in the background has completed.
+	wait := func() ([]Sensor, error) {
+		for {
+			sensors, pending, err := d.Start()
+			if !pending {
+				return sensors, err
+			}
+			time.Sleep(time.Millisecond)
+		}
+	}
+
+	_, pending, _ := d.Start()
+	require.True(t, pending)
+	_, err := wait()
+	require.Equal(t, failed, err)
+
+	// The failure is reported rather than pending until its backoff has
+	// passed.
+	_, pending, err = d.Start()
+	require.False(t, pending)
+	require.Equal(t, failed, err)
+	require.Equal(t, 1, calls)
+
+	// Then another attempt is started in the background.
+	*now = now.Add(discoverRetryMin)
+	_, pending, _ = d.Start()
+	require.True(t, pending)
+	sensors, err := wait()
+	require.NoError(t, err)
+	require.Len(t, sensors, 1)
+	require.Equal(t, 2, calls)
+}
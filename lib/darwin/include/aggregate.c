@@ -0,0 +1,133 @@
+#include "aggregate.h"
+
+#include <math.h>
+#include <string.h>
+
+#define P2_QUANTILE 0.95
+
+static const double p2_increments[5] = {0, P2_QUANTILE / 2, P2_QUANTILE,
+                                        (1 + P2_QUANTILE) / 2, 1};
+
+static void p2_reset(p2_t *p) { memset(p, 0, sizeof(p2_t)); }
+
+// p2_parabolic is the piecewise-parabolic prediction for marker i moved by d.
+static double p2_parabolic(const p2_t *p, int i, double d) {
+  const double *q = p->heights;
+  const double *n = p->positions;
+
+  return q[i] + d / (n[i + 1] - n[i - 1]) *
+                    ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) /
+                         (n[i + 1] - n[i]) +
+                     (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) /
+                         (n[i] - n[i - 1]));
+}
+
+static void p2_add(p2_t *p, double x) {
+  double *q = p->heights;
+  double *n = p->positions;
+  int k;
+
+  if (p->count < 5) {
+    // Keep the first five observations sorted; they become the markers.
+    int i = (int)p->count++;
+    while (i > 0 && q[i - 1] > x) {
+      q[i] = q[i - 1];
+      i--;
+    }
+    q[i] = x;
+
+    if (p->count == 5) {
+      for (i = 0; i < 5; i++) {
+        n[i] = i + 1;
+      }
+      p->desired[0] = 1;
+      p->desired[1] = 1 + 2 * P2_QUANTILE;
+      p->desired[2] = 1 + 4 * P2_QUANTILE;
+      p->desired[3] = 3 + 2 * P2_QUANTILE;
+      p->desired[4] = 5;
+    }
+    return;
+  }
+  p->count++;
+
+  // Find the cell x falls in, extending the extremes if needed.
+  if (x < q[0]) {
+    q[0] = x;
+    k = 0;
+  } else if (x >= q[4]) {
+    q[4] = x;
+    k = 3;
+  } else {
+    for (k = 0; k < 3 && x >= q[k + 1]; k++) {
+    }
+  }
+
+  for (int i = k + 1; i < 5; i++) {
+    n[i]++;
+  }
+  for (int i = 0; i < 5; i++) {
+    p->desired[i] += p2_increments[i];
+  }
+
+  // Move the middle markers that drifted a position or more off.
+  for (int i = 1; i < 4; i++) {
+    double d = p->desired[i] - n[i];
+
+    if ((d >= 1 && n[i + 1] - n[i] > 1) || (d <= -1 && n[i - 1] - n[i] < -1)) {
+      double step = d > 0 ? 1 : -1;
+      double h = p2_parabolic(p, i, step);
+
+      if (!(q[i - 1] < h && h < q[i + 1])) {
+        int j = i + (int)step;
+        h = q[i] + step * (q[j] - q[i]) / (n[j] - n[i]);
+      }
+      q[i] = h;
+      n[i] += step;
+    }
+  }
+}
+
+static double p2_estimate(const p2_t *p) {
+  if (p->count == 0) {
+    return 0;
+  }
+  if (p->count < 5) {
+    // Nearest rank over the few observations there are.
+    int rank = (int)ceil(P2_QUANTILE * p->count);
+    return p->heights[rank - 1];
+  }
+  return p->heights[2];
+}
+
+void window_reset(window_t *w) {
+  w->count = 0;
+  w->min = 0;
+  w->max = 0;
+  w->sum = 0;
+  p2_reset(&w->p95);
+}
+
+void window_add(window_t *w, double value) {
+  if (w->count == 0 || value < w->min) {
+    w->min = value;
+  }
+  if (w->count == 0 || value > w->max) {
+    w->max = value;
+  }
+  w->count++;
+  w->sum += value;
+  p2_add(&w->p95, value);
+}
+
+void window_summarize(const window_t *w, smc_aggregate_t *out) {
+  memset(out, 0, sizeof(smc_aggregate_t));
+  if (w->count == 0) {
+    return;
+  }
+
+  out->count = w->count;
+  out->min = (float)w->min;
+  out->max = (float)w->max;
+  out->mean = (float)(w->sum / w->count);
+  out->p95 = (float)p2_estimate(&w->p95);
+}
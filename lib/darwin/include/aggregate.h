@@ -0,0 +1,45 @@
+#ifndef __AGGREGATE_H__
+#define __AGGREGATE_H__ 1
+
+#include <stdint.h>
+
+// smc_aggregate_t summarizes the readings of one key over a window.
+typedef struct {
+  uint32_t count; // readings in the window; the rest is 0 when there are none.
+  float min;
+  float max;
+  float mean;
+  float p95; // estimated, see p2_t.
+} smc_aggregate_t;
+
+// p2_t estimates the 95th percentile of a stream with the P² algorithm (Jain
+// and Chlamtac, 1985): five markers track the minimum, the p/2, p and
+// (1+p)/2 quantiles and the maximum, and are nudged towards their desired
+// positions on every observation. It takes constant time and space per
+// observation, without keeping the observations themselves.
+typedef struct {
+  uint32_t count;
+  double heights[5];
+  double positions[5];
+  double desired[5];
+} p2_t;
+
+// window_t accumulates the aggregate of one key over the current window.
+typedef struct {
+  uint32_t count;
+  double min;
+  double max;
+  double sum;
+  p2_t p95;
+} window_t;
+
+// window_reset empties w.
+void window_reset(window_t *w);
+
+// window_add adds a reading to w in constant time.
+void window_add(window_t *w, double value);
+
+// window_summarize writes the aggregate of w into out.
+void window_summarize(const window_t *w, smc_aggregate_t *out);
+
+#endif // __AGGREGATE_H__
@@ -0,0 +1,203 @@
+#include "hid.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The IOHIDEventSystemClient API is private, so it is declared here. These
+// are the same declarations used by every tool that reads Apple Silicon
+// thermal sensors.
+typedef struct __IOHIDEventSystemClient *IOHIDEventSystemClientRef;
+typedef struct __IOHIDServiceClient *IOHIDServiceClientRef;
+typedef struct __IOHIDEvent *IOHIDEventRef;
+
+IOHIDEventSystemClientRef IOHIDEventSystemClientCreate(CFAllocatorRef allocator);
+int IOHIDEventSystemClientSetMatching(IOHIDEventSystemClientRef client,
+                                      CFDictionaryRef match);
+CFArrayRef IOHIDEventSystemClientCopyServices(IOHIDEventSystemClientRef client);
+CFTypeRef IOHIDServiceClientCopyProperty(IOHIDServiceClientRef service,
+                                         CFStringRef property);
+IOHIDEventRef IOHIDServiceClientCopyEvent(IOHIDServiceClientRef service,
+                                          int64_t type, int32_t options,
+                                          int64_t timestamp);
+double IOHIDEventGetFloatValue(IOHIDEventRef event, int32_t field);
+
+#define kIOHIDEventTypeTemperature 15
+#define IOHIDEventFieldBase(type) ((type) << 16)
+
+// Thermal sensors are Apple vendor page services with the temperature usage.
+#define kHIDPage_AppleVendor 0xff00
+#define kHIDUsage_AppleVendor_TemperatureSensor 0x0005
+
+// registry holds the sensors found by the first enumeration. Clients created
+// later match their services against it by name, so that sensor i refers to
+// the same sensor through every client.
+static struct {
+  pthread_once_t once;
+  int count;
+  char names[HID_MAX_SENSORS][HID_NAME_SIZE];
+} registry = {PTHREAD_ONCE_INIT, 0, {{0}}};
+
+struct hid_client {
+  IOHIDEventSystemClientRef system;
+  CFArrayRef services;
+  IOHIDServiceClientRef sensors[HID_MAX_SENSORS]; // indexed like registry.
+};
+
+static CFDictionaryRef temperature_matching(void) {
+  int page = kHIDPage_AppleVendor;
+  int usage = kHIDUsage_AppleVendor_TemperatureSensor;
+  CFNumberRef values[2];
+  CFStringRef keys[2] = {CFSTR("PrimaryUsagePage"), CFSTR("PrimaryUsage")};
+  CFDictionaryRef matching;
+
+  values[0] = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &page);
+  values[1] = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &usage);
+  matching = CFDictionaryCreate(kCFAllocatorDefault, (const void **)keys,
+                                (const void **)values, 2,
+                                &kCFTypeDictionaryKeyCallBacks,
+                                &kCFTypeDictionaryValueCallBacks);
+  CFRelease(values[0]);
+  CFRelease(values[1]);
+  return matching;
+}
+
+// service_name copies the product name of service into name, returning 0 if
+// it has none.
+static int service_name(IOHIDServiceClientRef service, char *name) {
+  CFTypeRef product = IOHIDServiceClientCopyProperty(service, CFSTR("Product"));
+  int ok = 0;
+
+  if (product == NULL) {
+    return 0;
+  }
+  if (CFGetTypeID(product) == CFStringGetTypeID()) {
+    ok = CFStringGetCString((CFStringRef)product, name, HID_NAME_SIZE,
+                           kCFStringEncodingUTF8);
+  }
+  CFRelease(product);
+  return ok;
+}
+
+static hid_client_t *client_create(void) {
+  hid_client_t *client;
+  CFDictionaryRef matching;
+
+  client = calloc(1, sizeof(hid_client_t));
+  if (client == NULL) {
+    return NULL;
+  }
+
+  client->system = IOHIDEventSystemClientCreate(kCFAllocatorDefault);
+  if (client->system == NULL) {
+    free(client);
+    return NULL;
+  }
+
+  matching = temperature_matching();
+  IOHIDEventSystemClientSetMatching(client->system, matching);
+  CFRelease(matching);
+
+  client->services = IOHIDEventSystemClientCopyServices(client->system);
+  return client;
+}
+
+static void enumerate(void) {
+  hid_client_t *client = client_create();
+  char name[HID_NAME_SIZE];
+
+  if (client == NULL) {
+    return;
+  }
+
+  if (client->services != NULL) {
+    for (CFIndex i = 0; i < CFArrayGetCount(client->services) &&
+                        registry.count < HID_MAX_SENSORS;
+         i++) {
+      IOHIDServiceClientRef service =
+          (IOHIDServiceClientRef)CFArrayGetValueAtIndex(client->services, i);
+      if (service_name(service, name)) {
+        memcpy(registry.names[registry.count++], name, HID_NAME_SIZE);
+      }
+    }
+  }
+
+  hid_close(client);
+}
+
+int hid_sensor_count(void) {
+  pthread_once(&registry.once, enumerate);
+  return registry.count;
+}
+
+const char *hid_sensor_name(int i) {
+  if (i < 0 || i >= hid_sensor_count()) {
+    return NULL;
+  }
+  return registry.names[i];
+}
+
+hid_client_t *hid_open(void) {
+  hid_client_t *client;
+  char name[HID_NAME_SIZE];
+  int count = hid_sensor_count();
+
+  client = client_create();
+  if (client == NULL || client->services == NULL) {
+    return client;
+  }
+
+  // Sensors may share a name, so each service takes the first registry
+  // entry of its name that is still unclaimed.
+  for (CFIndex i = 0; i < CFArrayGetCount(client->services); i++) {
+    IOHIDServiceClientRef service =
+        (IOHIDServiceClientRef)CFArrayGetValueAtIndex(client->services, i);
+    if (!service_name(service, name)) {
+      continue;
+    }
+    for (int j = 0; j < count; j++) {
+      if (client->sensors[j] == NULL &&
+          strncmp(registry.names[j], name, HID_NAME_SIZE) == 0) {
+        client->sensors[j] = service;
+        break;
+      }
+    }
+  }
+
+  return client;
+}
+
+void hid_close(hid_client_t *client) {
+  if (client == NULL) {
+    return;
+  }
+  // The service references are owned by the services array.
+  if (client->services != NULL) {
+    CFRelease(client->services);
+  }
+  if (client->system != NULL) {
+    CFRelease(client->system);
+  }
+  free(client);
+}
+
+int hid_read_temperature(hid_client_t *client, int i, double *value) {
+  IOHIDEventRef event;
+
+  *value = 0.0;
+
+  if (i < 0 || i >= HID_MAX_SENSORS || client->sensors[i] == NULL) {
+    return -1;
+  }
+
+  event = IOHIDServiceClientCopyEvent(client->sensors[i],
+                                      kIOHIDEventTypeTemperature, 0, 0);
+  if (event == NULL) {
+    return -1;
+  }
+
+  *value = IOHIDEventGetFloatValue(
+      event, IOHIDEventFieldBase(kIOHIDEventTypeTemperature));
+  CFRelease(event);
+  return 0;
+}
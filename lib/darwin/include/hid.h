@@ -0,0 +1,39 @@
+#ifndef __HID_H__
+#define __HID_H__ 1
+
+#include <IOKit/IOKitLib.h>
+
+// Apple Silicon Macs publish most of their thermal sensors as HID services
+// rather than SMC keys. The functions below read them through the private
+// IOHIDEventSystemClient API, which is what powermetrics and Activity Monitor
+// use.
+
+// HID_MAX_SENSORS bounds the number of HID temperature sensors tracked.
+#define HID_MAX_SENSORS 64
+
+// HID_NAME_SIZE is the size of a sensor's name buffer, including the NUL.
+#define HID_NAME_SIZE 32
+
+// hid_sensor_count returns the number of HID temperature sensors on the host.
+// They are enumerated by the first call and numbered in that order for the
+// life of the process; it is safe to call from any thread.
+int hid_sensor_count(void);
+
+// hid_sensor_name returns the product name of sensor i, e.g. "PMU tdie1".
+const char *hid_sensor_name(int i);
+
+// hid_client_t is an open event system client with its own references to every
+// sensor. Like an SMC handle, a client must not be used by more than one
+// thread at a time.
+typedef struct hid_client hid_client_t;
+
+// hid_open creates a client, returning NULL if the event system is not
+// available. It must be released with hid_close.
+hid_client_t *hid_open(void);
+void hid_close(hid_client_t *client);
+
+// hid_read_temperature reads sensor i in degrees Celsius. It returns 0 on
+// success and -1 if the sensor has gone away or reported no event.
+int hid_read_temperature(hid_client_t *client, int i, double *value);
+
+#endif // __HID_H__
@@ -0,0 +1,718 @@
+#include "sampler.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// history_t is the ring of snapshots laid out column by column: every slot's
+// timestamp is in timestamps, and values[i] holds the readings of key i in
+// every slot, so that the history of one key is a single contiguous array.
+// Values are stored as floats, NaN when the read failed, which is ample for
+// the SMC's 16 bit fixed point types.
+//
+// Each slot is guarded by a sequence lock: seq[slot] is odd while the sampler
+// is writing the slot and 2 * the snapshot's sequence once it is complete.
+// The payload is stored as relaxed atomics so that a reader racing with the
+// writer is well defined; it simply retries.
+typedef struct {
+  _Atomic uint64_t seq[SMC_SAMPLER_RING_SIZE];
+  _Atomic uint64_t timestamps[SMC_SAMPLER_RING_SIZE];
+  _Atomic uint32_t values[SMC_SAMPLER_MAX_SENSORS]
+                        [SMC_SAMPLER_RING_SIZE]; // IEEE 754 bit patterns.
+  _Atomic uint8_t statuses[SMC_SAMPLER_MAX_SENSORS][SMC_SAMPLER_RING_SIZE];
+} history_t;
+
+// worker_t reads keys [first, first + count) of every pass through its own
+// handle.
+typedef struct {
+  smc_sampler_t *sampler;
+  smc_handle_t *handle;
+  int first;
+  int count;
+  pthread_t thread;
+} worker_t;
+
+struct smc_sampler {
+  smc_handle_t *handle;
+  int count;
+  smc_key_t keys[SMC_SAMPLER_MAX_SENSORS];
+  smc_sampler_config_t config;
+
+  // workers is the number of worker threads, 0 if the sampler thread reads
+  // every key itself. A pass is started by incrementing pass and completes
+  // once pending drops to 0; both are guarded by lock. Each worker writes
+  // its share of values and statuses, which the sampler reads once the pass
+  // is complete.
+  int workers;
+  worker_t worker[SMC_SAMPLER_MAX_WORKERS];
+  uint64_t pass;
+  int pending;
+  pthread_cond_t pass_cond; // signals workers that a pass has started.
+  pthread_cond_t done_cond; // signals the sampler that a pass is complete.
+  double values[SMC_SAMPLER_MAX_SENSORS];
+  uint8_t statuses[SMC_SAMPLER_MAX_SENSORS];
+
+  // interval_ms is only written by the sampler thread; it is atomic so that
+  // smc_sampler_interval can report it.
+  _Atomic uint32_t interval_ms;
+
+  // head is the sequence of the latest complete snapshot, 0 if none.
+  _Atomic uint64_t head;
+  history_t history;
+
+  // windows accumulates the window that started at window_start, and
+  // ewma_ns is when each key's moving average was last updated. Only the
+  // sampler thread uses them; what readers see is published to aggregates,
+  // guarded by aggregates_lock, once per pass.
+  uint64_t window_start;
+  window_t windows[SMC_SAMPLER_MAX_SENSORS];
+  uint64_t ewma_ns[SMC_SAMPLER_MAX_SENSORS];
+  int aggregated; // a window has completed.
+  smc_aggregates_t aggregates;
+  pthread_mutex_t aggregates_lock;
+
+  // thresholds and levels hold the watermarks and current level of each
+  // key, and events the queue of level changes, events_count long from
+  // events_head. All of them are guarded by events_lock; events_cond
+  // signals waiters that events were queued or closed.
+  smc_threshold_t thresholds[SMC_SAMPLER_MAX_SENSORS];
+  uint8_t levels[SMC_SAMPLER_MAX_SENSORS];
+  int armed; // number of keys with watermarks.
+  smc_threshold_event_t events[SMC_SAMPLER_MAX_EVENTS];
+  int events_head;
+  int events_count;
+  uint64_t events_dropped;
+  int events_closed;
+  pthread_mutex_t events_lock;
+  pthread_cond_t events_cond;
+
+  pthread_t thread;
+  pthread_mutex_t lock; // guards stopping, used only to wake the thread.
+  pthread_cond_t cond;
+  int stopping;
+};
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t float_bits(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+static float bits_float(uint32_t bits) {
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static int ring_slot(uint64_t sequence) {
+  return (int)(sequence & (SMC_SAMPLER_RING_SIZE - 1));
+}
+
+static void publish(smc_sampler_t *s, const double *values,
+                    const uint8_t *statuses, uint64_t timestamp) {
+  history_t *h = &s->history;
+  uint64_t sequence =
+      atomic_load_explicit(&s->head, memory_order_relaxed) + 1;
+  int slot = ring_slot(sequence);
+
+  atomic_store_explicit(&h->seq[slot], 2 * sequence - 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  atomic_store_explicit(&h->timestamps[slot], timestamp, memory_order_relaxed);
+  for (int i = 0; i < s->count; i++) {
+    float value = statuses[i] == SMC_OK ? (float)values[i] : NAN;
+    atomic_store_explicit(&h->values[i][slot], float_bits(value),
+                          memory_order_relaxed);
+    atomic_store_explicit(&h->statuses[i][slot], statuses[i],
+                          memory_order_relaxed);
+  }
+
+  atomic_store_explicit(&h->seq[slot], 2 * sequence, memory_order_release);
+  atomic_store_explicit(&s->head, sequence, memory_order_release);
+}
+
+// aggregate folds a pass into the windows and moving averages, closing the
+// current window once it has lasted window_ms.
+static void aggregate(smc_sampler_t *s, const double *values,
+                      const uint8_t *statuses, uint64_t timestamp) {
+  smc_aggregates_t *a = &s->aggregates;
+  uint64_t window_ns = (uint64_t)s->config.window_ms * 1000000ull;
+  double tau = (double)s->config.ewma_ms * 1e6;
+
+  if (window_ns == 0) {
+    return;
+  }
+  if (s->window_start == 0) {
+    s->window_start = timestamp;
+  }
+
+  pthread_mutex_lock(&s->aggregates_lock);
+
+  if (timestamp - s->window_start >= window_ns) {
+    a->window_start = s->window_start;
+    a->window_end = timestamp;
+    for (int i = 0; i < s->count; i++) {
+      window_summarize(&s->windows[i], &a->keys[i]);
+      window_reset(&s->windows[i]);
+    }
+    s->window_start = timestamp;
+    s->aggregated = 1;
+  }
+
+  for (int i = 0; i < s->count; i++) {
+    if (statuses[i] != SMC_OK) {
+      continue;
+    }
+    window_add(&s->windows[i], values[i]);
+
+    if (isnan(a->ewma[i]) || tau <= 0) {
+      a->ewma[i] = (float)values[i];
+    } else {
+      double alpha = 1 - exp(-(double)(timestamp - s->ewma_ns[i]) / tau);
+      a->ewma[i] += (float)(alpha * (values[i] - a->ewma[i]));
+    }
+    s->ewma_ns[i] = timestamp;
+  }
+
+  pthread_mutex_unlock(&s->aggregates_lock);
+}
+
+// check_thresholds moves every key with watermarks to its level after a pass,
+// queueing an event for each key whose level changed.
+static void check_thresholds(smc_sampler_t *s, const double *values,
+                             const uint8_t *statuses, uint64_t timestamp) {
+  int queued = 0;
+
+  pthread_mutex_lock(&s->events_lock);
+  for (int i = 0; s->armed > 0 && i < s->count; i++) {
+    smc_level_t level;
+    smc_threshold_event_t *event;
+
+    if (statuses[i] != SMC_OK || !threshold_enabled(&s->thresholds[i])) {
+      continue;
+    }
+
+    level = threshold_level(&s->thresholds[i], (smc_level_t)s->levels[i],
+                            (float)values[i]);
+    if (level == s->levels[i]) {
+      continue;
+    }
+
+    if (s->events_count == SMC_SAMPLER_MAX_EVENTS) {
+      s->events_head = (s->events_head + 1) % SMC_SAMPLER_MAX_EVENTS;
+      s->events_count--;
+      s->events_dropped++;
+    }
+    event = &s->events[(s->events_head + s->events_count) %
+                       SMC_SAMPLER_MAX_EVENTS];
+    event->timestamp = timestamp;
+    event->index = i;
+    event->level = (uint8_t)level;
+    event->previous = s->levels[i];
+    event->value = (float)values[i];
+    s->events_count++;
+    s->levels[i] = (uint8_t)level;
+    queued = 1;
+  }
+  if (queued) {
+    pthread_cond_broadcast(&s->events_cond);
+  }
+  pthread_mutex_unlock(&s->events_lock);
+}
+
+// ring_value loads the value of key i from the slot of the given sequence,
+// NaN if it was not read. Only the sampler thread calls it, on slots it has
+// finished writing.
+static float ring_value(smc_sampler_t *s, uint64_t sequence, int i) {
+  return bits_float(atomic_load_explicit(
+      &s->history.values[i][ring_slot(sequence)], memory_order_relaxed));
+}
+
+static uint64_t ring_timestamp(smc_sampler_t *s, uint64_t sequence) {
+  return atomic_load_explicit(&s->history.timestamps[ring_slot(sequence)],
+                              memory_order_relaxed);
+}
+
+// changing_fast reports whether any key moved faster than the rate threshold
+// between the two latest snapshots.
+static int changing_fast(smc_sampler_t *s, uint64_t sequence) {
+  double seconds, value, previous;
+
+  if (s->config.rate_threshold <= 0 || sequence < 2) {
+    return 0;
+  }
+
+  seconds = (double)(ring_timestamp(s, sequence) -
+                     ring_timestamp(s, sequence - 1)) /
+            1e9;
+  if (seconds <= 0) {
+    return 0;
+  }
+
+  for (int i = 0; i < s->count; i++) {
+    value = ring_value(s, sequence, i);
+    previous = ring_value(s, sequence - 1, i);
+    // Comparisons with a missing (NaN) reading are false.
+    if (fabs(value - previous) / seconds > s->config.rate_threshold) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// quiet reports whether every key varied less than the variance threshold
+// over a full ring buffer of snapshots.
+static int quiet(smc_sampler_t *s, uint64_t sequence) {
+  if (s->config.variance_threshold <= 0 ||
+      sequence < SMC_SAMPLER_RING_SIZE) {
+    return 0;
+  }
+
+  for (int i = 0; i < s->count; i++) {
+    // Welford's algorithm, over the readings that succeeded. The ring is
+    // full, so the order of the slots does not matter and the key's column
+    // is scanned straight through.
+    double mean = 0, m2 = 0, value;
+    int n = 0;
+
+    for (int slot = 0; slot < SMC_SAMPLER_RING_SIZE; slot++) {
+      value = bits_float(atomic_load_explicit(&s->history.values[i][slot],
+                                              memory_order_relaxed));
+      if (isnan(value)) {
+        continue;
+      }
+      n++;
+      double delta = value - mean;
+      mean += delta / n;
+      m2 += delta * (value - mean);
+    }
+
+    if (n > 1 && m2 / (n - 1) >= s->config.variance_threshold) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// next_interval adapts the interval after the pass that published sequence.
+static uint32_t next_interval(smc_sampler_t *s, uint64_t sequence) {
+  uint32_t interval = atomic_load_explicit(&s->interval_ms,
+                                           memory_order_relaxed);
+  uint32_t max = s->config.max_interval_ms;
+
+  if (max <= s->config.min_interval_ms) {
+    return s->config.min_interval_ms;
+  }
+  if (changing_fast(s, sequence)) {
+    return s->config.min_interval_ms;
+  }
+  if (quiet(s, sequence)) {
+    return interval > max / 2 ? max : interval * 2;
+  }
+  return interval;
+}
+
+static void *worker_loop(void *arg) {
+  worker_t *w = arg;
+  smc_sampler_t *s = w->sampler;
+  uint64_t seen = 0;
+
+  pthread_mutex_lock(&s->lock);
+  for (;;) {
+    while (s->pass == seen && !s->stopping) {
+      pthread_cond_wait(&s->pass_cond, &s->lock);
+    }
+    if (s->pass == seen) {
+      // Stopping, and no pass is waiting on this worker.
+      break;
+    }
+    seen = s->pass;
+    pthread_mutex_unlock(&s->lock);
+
+    read_smc_many(w->handle, &s->keys[w->first], &s->values[w->first],
+                  &s->statuses[w->first], w->count);
+
+    pthread_mutex_lock(&s->lock);
+    if (--s->pending == 0) {
+      pthread_cond_signal(&s->done_cond);
+    }
+  }
+  pthread_mutex_unlock(&s->lock);
+
+  return NULL;
+}
+
+// read_pass reads every key into s->values and s->statuses, in parallel when
+// the sampler has workers.
+static void read_pass(smc_sampler_t *s) {
+  if (s->workers == 0) {
+    read_smc_many(s->handle, s->keys, s->values, s->statuses, s->count);
+    return;
+  }
+
+  pthread_mutex_lock(&s->lock);
+  s->pass++;
+  s->pending = s->workers;
+  pthread_cond_broadcast(&s->pass_cond);
+  while (s->pending > 0) {
+    pthread_cond_wait(&s->done_cond, &s->lock);
+  }
+  pthread_mutex_unlock(&s->lock);
+}
+
+static void *sampler_loop(void *arg) {
+  smc_sampler_t *s = arg;
+  struct timespec deadline;
+  uint32_t interval_ms;
+  uint64_t timestamp;
+
+  pthread_mutex_lock(&s->lock);
+  while (!s->stopping) {
+    pthread_mutex_unlock(&s->lock);
+
+    read_pass(s);
+    timestamp = now_ns();
+    publish(s, s->values, s->statuses, timestamp);
+    aggregate(s, s->values, s->statuses, timestamp);
+    check_thresholds(s, s->values, s->statuses, timestamp);
+
+    interval_ms =
+        next_interval(s, atomic_load_explicit(&s->head, memory_order_relaxed));
+    atomic_store_explicit(&s->interval_ms, interval_ms, memory_order_relaxed);
+
+    pthread_mutex_lock(&s->lock);
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += interval_ms / 1000;
+    deadline.tv_nsec += (long)(interval_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    while (!s->stopping &&
+           pthread_cond_timedwait(&s->cond, &s->lock, &deadline) == 0) {
+      // Woken early without being stopped; keep waiting for the deadline.
+    }
+  }
+  pthread_mutex_unlock(&s->lock);
+
+  return NULL;
+}
+
+// stop_workers stops and joins the first n workers and closes their handles.
+static void stop_workers(smc_sampler_t *s, int n) {
+  pthread_mutex_lock(&s->lock);
+  s->stopping = 1;
+  pthread_cond_broadcast(&s->pass_cond);
+  pthread_mutex_unlock(&s->lock);
+
+  for (int i = 0; i < n; i++) {
+    pthread_join(s->worker[i].thread, NULL);
+    close_smc(s->worker[i].handle);
+  }
+}
+
+// start_workers splits the keys between the configured number of workers.
+static smc_error_t start_workers(smc_sampler_t *s) {
+  smc_error_t err;
+  int n = (int)s->config.workers;
+  int first = 0;
+
+  if (n > SMC_SAMPLER_MAX_WORKERS) {
+    n = SMC_SAMPLER_MAX_WORKERS;
+  }
+  if (n > s->count) {
+    n = s->count;
+  }
+  if (n <= 1) {
+    return SMC_OK;
+  }
+
+  for (int i = 0; i < n; i++) {
+    worker_t *w = &s->worker[i];
+
+    w->sampler = s;
+    w->first = first;
+    w->count = s->count / n + (i < s->count % n ? 1 : 0);
+    first += w->count;
+
+    err = open_smc(&w->handle);
+    if (err == SMC_OK &&
+        pthread_create(&w->thread, NULL, worker_loop, w) != 0) {
+      close_smc(w->handle);
+      err = SMC_ERR_NO_MEMORY;
+    }
+    if (err != SMC_OK) {
+      stop_workers(s, i);
+      s->stopping = 0;
+      return err;
+    }
+  }
+
+  s->workers = n;
+  return SMC_OK;
+}
+
+smc_error_t smc_sampler_start(const smc_key_t *keys, int count,
+                              const smc_sampler_config_t *config,
+                              smc_sampler_t **sampler) {
+  smc_error_t err;
+  smc_sampler_t *s;
+
+  *sampler = NULL;
+
+  if (count < 0 || count > SMC_SAMPLER_MAX_SENSORS || config == NULL ||
+      config->min_interval_ms == 0) {
+    return SMC_ERR_INVALID_ARGUMENT;
+  }
+
+  s = calloc(1, sizeof(smc_sampler_t));
+  if (s == NULL) {
+    return SMC_ERR_NO_MEMORY;
+  }
+
+  err = open_smc(&s->handle);
+  if (err != SMC_OK) {
+    free(s);
+    return err;
+  }
+
+  s->count = count;
+  memcpy(s->keys, keys, sizeof(smc_key_t) * (size_t)count);
+  s->config = *config;
+  atomic_init(&s->interval_ms, config->min_interval_ms);
+  s->aggregates.count = count;
+  for (int i = 0; i < count; i++) {
+    window_reset(&s->windows[i]);
+    s->aggregates.ewma[i] = NAN;
+    s->thresholds[i] = (smc_threshold_t){NAN, NAN, 0};
+  }
+  pthread_mutex_init(&s->aggregates_lock, NULL);
+  pthread_mutex_init(&s->events_lock, NULL);
+  pthread_cond_init(&s->events_cond, NULL);
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->cond, NULL);
+  pthread_cond_init(&s->pass_cond, NULL);
+  pthread_cond_init(&s->done_cond, NULL);
+
+  err = start_workers(s);
+  if (err == SMC_OK && pthread_create(&s->thread, NULL, sampler_loop, s) != 0) {
+    stop_workers(s, s->workers);
+    err = SMC_ERR_NO_MEMORY;
+  }
+  if (err != SMC_OK) {
+    pthread_cond_destroy(&s->done_cond);
+    pthread_cond_destroy(&s->pass_cond);
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->events_cond);
+    pthread_mutex_destroy(&s->events_lock);
+    pthread_mutex_destroy(&s->aggregates_lock);
+    close_smc(s->handle);
+    free(s);
+    return err;
+  }
+
+  *sampler = s;
+  return SMC_OK;
+}
+
+void smc_sampler_stop(smc_sampler_t *s) {
+  if (s == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&s->lock);
+  s->stopping = 1;
+  pthread_cond_signal(&s->cond);
+  pthread_mutex_unlock(&s->lock);
+
+  pthread_join(s->thread, NULL);
+  stop_workers(s, s->workers);
+
+  pthread_cond_destroy(&s->done_cond);
+  pthread_cond_destroy(&s->pass_cond);
+  pthread_cond_destroy(&s->cond);
+  pthread_mutex_destroy(&s->lock);
+  pthread_cond_destroy(&s->events_cond);
+  pthread_mutex_destroy(&s->events_lock);
+  pthread_mutex_destroy(&s->aggregates_lock);
+  close_smc(s->handle);
+  free(s);
+}
+
+int smc_sampler_aggregates(smc_sampler_t *s, smc_aggregates_t *aggregates) {
+  int ok;
+
+  pthread_mutex_lock(&s->aggregates_lock);
+  ok = s->aggregated;
+  if (ok) {
+    *aggregates = s->aggregates;
+  }
+  pthread_mutex_unlock(&s->aggregates_lock);
+
+  if (!ok) {
+    memset(aggregates, 0, sizeof(smc_aggregates_t));
+  }
+  return ok;
+}
+
+smc_error_t smc_sampler_set_threshold(smc_sampler_t *s, int index,
+                                      const smc_threshold_t *threshold) {
+  smc_threshold_t none = {NAN, NAN, 0};
+
+  if (index < 0 || index >= s->count) {
+    return SMC_ERR_INVALID_ARGUMENT;
+  }
+  if (threshold == NULL || !threshold_enabled(threshold)) {
+    threshold = &none;
+  }
+
+  pthread_mutex_lock(&s->events_lock);
+  s->armed += threshold_enabled(threshold) -
+              threshold_enabled(&s->thresholds[index]);
+  s->thresholds[index] = *threshold;
+  s->levels[index] = SMC_LEVEL_NORMAL;
+  pthread_mutex_unlock(&s->events_lock);
+
+  return SMC_OK;
+}
+
+int smc_sampler_wait_events(smc_sampler_t *s, smc_threshold_event_t *events,
+                            int max, uint32_t timeout_ms) {
+  struct timespec deadline;
+  int n = 0;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout_ms / 1000;
+  deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&s->events_lock);
+  while (s->events_count == 0 && !s->events_closed &&
+         pthread_cond_timedwait(&s->events_cond, &s->events_lock, &deadline) ==
+             0) {
+    // Woken without events, e.g. spuriously; keep waiting for the deadline.
+  }
+
+  if (s->events_closed) {
+    n = -1;
+  } else {
+    for (; n < max && s->events_count > 0; n++) {
+      events[n] = s->events[s->events_head];
+      s->events_head = (s->events_head + 1) % SMC_SAMPLER_MAX_EVENTS;
+      s->events_count--;
+    }
+  }
+  pthread_mutex_unlock(&s->events_lock);
+
+  return n;
+}
+
+uint64_t smc_sampler_events_dropped(smc_sampler_t *s) {
+  uint64_t dropped;
+
+  pthread_mutex_lock(&s->events_lock);
+  dropped = s->events_dropped;
+  pthread_mutex_unlock(&s->events_lock);
+
+  return dropped;
+}
+
+void smc_sampler_close_events(smc_sampler_t *s) {
+  pthread_mutex_lock(&s->events_lock);
+  s->events_closed = 1;
+  pthread_cond_broadcast(&s->events_cond);
+  pthread_mutex_unlock(&s->events_lock);
+}
+
+uint32_t smc_sampler_interval(smc_sampler_t *s) {
+  return atomic_load_explicit(&s->interval_ms, memory_order_relaxed);
+}
+
+int smc_sampler_latest(smc_sampler_t *s, smc_snapshot_t *snapshot) {
+  history_t *h = &s->history;
+
+  for (;;) {
+    uint64_t sequence = atomic_load_explicit(&s->head, memory_order_acquire);
+    uint64_t seq;
+    int slot;
+
+    if (sequence == 0) {
+      memset(snapshot, 0, sizeof(smc_snapshot_t));
+      return 0;
+    }
+
+    slot = ring_slot(sequence);
+    seq = atomic_load_explicit(&h->seq[slot], memory_order_acquire);
+    if (seq != 2 * sequence) {
+      // The slot has been lapped by the sampler; start over from the head.
+      continue;
+    }
+
+    snapshot->sequence = sequence;
+    snapshot->count = s->count;
+    snapshot->timestamp =
+        atomic_load_explicit(&h->timestamps[slot], memory_order_relaxed);
+    for (int i = 0; i < s->count; i++) {
+      snapshot->values[i] = bits_float(
+          atomic_load_explicit(&h->values[i][slot], memory_order_relaxed));
+      snapshot->statuses[i] =
+          atomic_load_explicit(&h->statuses[i][slot], memory_order_relaxed);
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&h->seq[slot], memory_order_relaxed) == seq) {
+      return 1;
+    }
+  }
+}
+
+int smc_sampler_history(smc_sampler_t *s, int index, float *values,
+                        uint64_t *timestamps) {
+  history_t *h = &s->history;
+  uint64_t head = atomic_load_explicit(&s->head, memory_order_acquire);
+  uint64_t first;
+  int n = 0;
+
+  if (index < 0 || index >= s->count || head == 0) {
+    return 0;
+  }
+
+  first = head >= SMC_SAMPLER_RING_SIZE ? head - SMC_SAMPLER_RING_SIZE + 1 : 1;
+  for (uint64_t sequence = first; sequence <= head; sequence++) {
+    int slot = ring_slot(sequence);
+    uint64_t seq = atomic_load_explicit(&h->seq[slot], memory_order_acquire);
+    uint64_t timestamp;
+    uint32_t bits;
+
+    if (seq != 2 * sequence) {
+      // Lapped while copying; the newer snapshots are still to come.
+      continue;
+    }
+
+    timestamp = atomic_load_explicit(&h->timestamps[slot], memory_order_relaxed);
+    bits = atomic_load_explicit(&h->values[index][slot], memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&h->seq[slot], memory_order_relaxed) != seq) {
+      continue;
+    }
+
+    values[n] = bits_float(bits);
+    timestamps[n] = timestamp;
+    n++;
+  }
+  return n;
+}
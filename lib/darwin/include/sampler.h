@@ -0,0 +1,139 @@
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__ 1
+
+#include "aggregate.h"
+#include "smc.h"
+#include "threshold.h"
+
+// SMC_SAMPLER_MAX_SENSORS is the most sensors a sampler can read.
+#define SMC_SAMPLER_MAX_SENSORS 128
+
+// SMC_SAMPLER_MAX_WORKERS is the most threads a sampler reads keys with.
+#define SMC_SAMPLER_MAX_WORKERS 8
+
+// SMC_SAMPLER_RING_SIZE is the number of snapshots the sampler keeps. It must
+// be a power of two.
+#define SMC_SAMPLER_RING_SIZE 16
+
+// SMC_SAMPLER_MAX_EVENTS is the number of threshold events the sampler queues
+// for smc_sampler_wait_events; the oldest are dropped beyond that.
+#define SMC_SAMPLER_MAX_EVENTS 64
+
+// smc_sampler_t reads a fixed set of keys on its own thread at a regular
+// interval and publishes every result as a snapshot in a ring buffer. The
+// sampler is the single producer; any number of threads may read snapshots
+// concurrently without locks and without entering the kernel.
+typedef struct smc_sampler smc_sampler_t;
+
+// smc_snapshot_t is one pass of the sampler over its keys. values and
+// statuses are indexed in the order the keys were given to the sampler.
+typedef struct {
+  uint64_t sequence;  // 1 for the first snapshot, 0 if there is none yet.
+  uint64_t timestamp; // wall clock time of the pass, ns since the Unix epoch.
+  int count;
+  float values[SMC_SAMPLER_MAX_SENSORS]; // NaN where the read failed.
+  uint8_t statuses[SMC_SAMPLER_MAX_SENSORS]; // smc_error_t per key.
+} smc_snapshot_t;
+
+// smc_sampler_config_t controls how often the sampler reads its keys. The
+// sampler starts at min_interval_ms and doubles its interval, up to
+// max_interval_ms, after every pass in which the variance of each key over the
+// ring buffer is below variance_threshold. As soon as any reading changes
+// faster than rate_threshold units per second it drops back to
+// min_interval_ms. Setting max_interval_ms to min_interval_ms samples at a
+// fixed rate; a zero threshold disables the corresponding check.
+//
+// With more than one worker the keys are split between that many threads,
+// each with its own SMC handle, which read their share of every pass at the
+// same time. A pass then takes as long as the slowest share rather than the
+// sum of every read, so one stalled key no longer delays the others.
+//
+// Every reading is also folded into per-key aggregates over consecutive
+// windows of window_ms, and into a moving average with a time constant of
+// ewma_ms; a window_ms of 0 disables both.
+typedef struct {
+  uint32_t min_interval_ms;
+  uint32_t max_interval_ms;
+  double variance_threshold;
+  double rate_threshold;
+  uint32_t workers;
+  uint32_t window_ms;
+  uint32_t ewma_ms;
+} smc_sampler_config_t;
+
+// smc_aggregates_t holds the aggregates of every key over the last complete
+// window, indexed in the order the keys were given to the sampler. ewma is
+// the current moving average of each key, NaN until it has been read, and
+// carries on across windows.
+typedef struct {
+  uint64_t window_start; // ns since the Unix epoch.
+  uint64_t window_end;
+  int count;
+  smc_aggregate_t keys[SMC_SAMPLER_MAX_SENSORS];
+  float ewma[SMC_SAMPLER_MAX_SENSORS];
+} smc_aggregates_t;
+
+// smc_threshold_event_t records a key moving from one level to another.
+typedef struct {
+  uint64_t timestamp; // wall clock time of the pass, ns since the Unix epoch.
+  int index;          // of the key, in the order given to the sampler.
+  uint8_t level;      // smc_level_t after the reading.
+  uint8_t previous;   // smc_level_t before the reading.
+  float value;
+} smc_threshold_event_t;
+
+// smc_sampler_start starts sampling count keys as configured by config. The
+// sampler opens its own SMC handles.
+smc_error_t smc_sampler_start(const smc_key_t *keys, int count,
+                              const smc_sampler_config_t *config,
+                              smc_sampler_t **sampler);
+
+// smc_sampler_interval returns the interval the sampler currently waits
+// between passes, in milliseconds.
+uint32_t smc_sampler_interval(smc_sampler_t *sampler);
+
+// smc_sampler_stop stops the sampling thread and frees the sampler. No other
+// call may be in progress; see smc_sampler_close_events.
+void smc_sampler_stop(smc_sampler_t *sampler);
+
+// smc_sampler_latest copies the most recent snapshot into snapshot. It returns
+// 0 if nothing has been sampled yet and 1 otherwise.
+int smc_sampler_latest(smc_sampler_t *sampler, smc_snapshot_t *snapshot);
+
+// smc_sampler_history copies the readings of key index from every snapshot
+// still in the ring buffer into values, NaN where the read failed, and their
+// timestamps into timestamps, oldest first. Both must have room for
+// SMC_SAMPLER_RING_SIZE entries. It returns the number of snapshots copied.
+int smc_sampler_history(smc_sampler_t *sampler, int index, float *values,
+                        uint64_t *timestamps);
+
+// smc_sampler_aggregates copies the aggregates of the last complete window
+// into aggregates in a single call. It returns 0 if no window has completed
+// yet or aggregates are disabled, and 1 otherwise.
+int smc_sampler_aggregates(smc_sampler_t *sampler,
+                           smc_aggregates_t *aggregates);
+
+// smc_sampler_set_threshold sets the watermarks of key index, or clears them
+// if threshold is NULL or has none, and resets the key to SMC_LEVEL_NORMAL.
+// From the next pass on, the sampler queues an event whenever the key's
+// level changes.
+smc_error_t smc_sampler_set_threshold(smc_sampler_t *sampler, int index,
+                                      const smc_threshold_t *threshold);
+
+// smc_sampler_wait_events waits up to timeout_ms for threshold events and
+// moves up to max of them, oldest first, into events. It returns the number
+// of events moved, 0 on timeout, or -1 once events have been closed.
+int smc_sampler_wait_events(smc_sampler_t *sampler,
+                            smc_threshold_event_t *events, int max,
+                            uint32_t timeout_ms);
+
+// smc_sampler_events_dropped returns how many events were dropped because the
+// queue was full.
+uint64_t smc_sampler_events_dropped(smc_sampler_t *sampler);
+
+// smc_sampler_close_events wakes every thread in smc_sampler_wait_events and
+// makes every later call return -1 at once, so that the sampler can be
+// stopped once they have returned.
+void smc_sampler_close_events(smc_sampler_t *sampler);
+
+#endif // __SAMPLER_H__
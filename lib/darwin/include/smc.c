@@ -1,9 +1,25 @@
 #include "smc.h"
+#include "hid.h"
+
+#include <IOKit/pwr_mgt/IOPMLib.h>
+#include <mach/mach.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/sysctl.h>
+#include <time.h>
 
 #define IOSERVICE_SMC "AppleSMC"
 #define IOSERVICE_MODEL "IOPlatformExpertDevice"
 
-#define DATA_TYPE_SP78 "sp78"
+#define DATA_TYPE_FLT SMC_KEY('f', 'l', 't', ' ')
+
+// DATA_TYPE_HID is reported as the data type of HID sensors.
+#define DATA_TYPE_HID SMC_KEY('h', 'i', 'd', ' ')
+
+// KEY_COUNT is the SMC key holding the number of keys the SMC exposes.
+#define KEY_COUNT SMC_KEY('#', 'K', 'E', 'Y')
 
 typedef enum {
   kSMCUserClientOpen = 0,
@@ -14,6 +30,7 @@ typedef enum {
   kSMCGetKeyCount = 7,
   kSMCGetKeyFromIndex = 8,
   kSMCGetKeyInfo = 9,
+  kSMCGetPLimits = 11,
 } selector_t;
 
 typedef struct {
@@ -64,9 +81,187 @@ typedef struct {
 } smc_return_t;
 
 static const int SMC_KEY_SIZE = 4; // number of characters in an SMC key.
-static io_connect_t conn;          // our connection to the SMC.
 
-kern_return_t open_smc(void) {
+static smc_log_fn log_fn; // receives errors, see smc_set_log_func.
+
+void smc_set_log_func(smc_log_fn fn) { log_fn = fn; }
+
+static smc_error_t log_error(smc_error_t err, smc_key_t key,
+                             kern_return_t io_result, const char *msg) {
+  if (log_fn != NULL) {
+    log_fn(err, key, (int32_t)io_result, msg);
+  }
+  return err;
+}
+
+typedef struct {
+  _Atomic uint64_t count;
+  _Atomic uint64_t sum_ns;
+  _Atomic uint64_t buckets[SMC_LATENCY_BUCKETS];
+} histogram_t;
+
+// stats backs smc_get_stats. Separate handles are used from many threads, so
+// every update is a relaxed atomic add; nothing orders against the counters.
+static struct {
+  _Atomic uint64_t calls;
+  _Atomic uint64_t key_not_found;
+  _Atomic uint64_t missing_cached;
+  _Atomic uint64_t reconnects;
+  _Atomic uint64_t decode_failures;
+  histogram_t call_latency;
+  histogram_t reconnect_latency;
+} stats;
+
+static void counter_inc(_Atomic uint64_t *counter) {
+  atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static uint64_t uptime_ns(void) {
+  return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static void histogram_observe(histogram_t *h, uint64_t start_ns) {
+  uint64_t ns = uptime_ns() - start_ns;
+  int bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+
+  if (bucket >= SMC_LATENCY_BUCKETS) {
+    bucket = SMC_LATENCY_BUCKETS - 1;
+  }
+
+  atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->sum_ns, ns, memory_order_relaxed);
+  atomic_fetch_add_explicit(&h->buckets[bucket], 1, memory_order_relaxed);
+}
+
+static void histogram_copy(smc_histogram_t *dst, histogram_t *src) {
+  dst->count = atomic_load_explicit(&src->count, memory_order_relaxed);
+  dst->sum_ns = atomic_load_explicit(&src->sum_ns, memory_order_relaxed);
+  for (int i = 0; i < SMC_LATENCY_BUCKETS; i++) {
+    dst->buckets[i] =
+        atomic_load_explicit(&src->buckets[i], memory_order_relaxed);
+  }
+}
+
+void smc_get_stats(smc_stats_t *out) {
+  out->calls = atomic_load_explicit(&stats.calls, memory_order_relaxed);
+  out->key_not_found =
+      atomic_load_explicit(&stats.key_not_found, memory_order_relaxed);
+  out->missing_cached =
+      atomic_load_explicit(&stats.missing_cached, memory_order_relaxed);
+  out->reconnects =
+      atomic_load_explicit(&stats.reconnects, memory_order_relaxed);
+  out->decode_failures =
+      atomic_load_explicit(&stats.decode_failures, memory_order_relaxed);
+  histogram_copy(&out->call_latency, &stats.call_latency);
+  histogram_copy(&out->reconnect_latency, &stats.reconnect_latency);
+}
+
+// The size and type of an SMC key never change while the machine is booted,
+// so the result of kSMCGetKeyInfo is cached per key. This lets steady-state
+// reads skip straight to kSMCReadKey with a single IOKit call. Keys the SMC
+// reports as kSMCKeyNotFound are cached too, so that missing sensors are
+// answered without entering the kernel at all.
+#define KEY_INFO_CACHE_SIZE 256 // must be a power of two.
+
+typedef struct {
+  smc_key_t key;   // 0 marks an empty slot.
+  uint8_t missing; // the SMC does not have this key.
+  SMCKeyInfoData key_info;
+} key_info_entry_t;
+
+// smc_handle holds a connection to the SMC along with the caches for that
+// connection. Handles share no state, so separate threads can each read
+// through their own handle without any locking.
+struct smc_handle {
+  io_connect_t conn;
+  uint64_t io_calls; // IOConnectCallStructMethod calls, see smc_io_calls.
+  key_info_entry_t key_info_cache[KEY_INFO_CACHE_SIZE];
+  hid_client_t *hid; // opened by the first read of an SMC_HID_KEY.
+};
+
+static struct {
+  pthread_once_t once;
+  smc_backend_t backend;
+} backend = {PTHREAD_ONCE_INIT, SMC_BACKEND_SMC};
+
+// is_apple_silicon reports whether the host is an arm64 Mac, including when
+// this process is translated by Rosetta.
+static int is_apple_silicon(void) {
+  int arm64 = 0;
+  size_t size = sizeof(arm64);
+
+  if (sysctlbyname("hw.optional.arm64", &arm64, &size, NULL, 0) != 0) {
+    return 0;
+  }
+  return arm64;
+}
+
+static void select_backend(void) {
+  if (is_apple_silicon() && hid_sensor_count() > 0) {
+    backend.backend = SMC_BACKEND_HID;
+  }
+}
+
+smc_backend_t smc_backend(void) {
+  pthread_once(&backend.once, select_backend);
+  return backend.backend;
+}
+
+static uint32_t key_info_cache_slot(smc_key_t key) {
+  // Fibonacci hashing spreads the four ASCII bytes of a key across the table.
+  return (key * 2654435761u) & (KEY_INFO_CACHE_SIZE - 1);
+}
+
+static const key_info_entry_t *key_info_cache_get(smc_handle_t *handle,
+                                                  smc_key_t key) {
+  uint32_t slot = key_info_cache_slot(key);
+
+  for (int i = 0; i < KEY_INFO_CACHE_SIZE; i++) {
+    key_info_entry_t *entry = &handle->key_info_cache[slot];
+    if (entry->key == key) {
+      return entry;
+    }
+    if (entry->key == 0) {
+      return NULL;
+    }
+    slot = (slot + 1) & (KEY_INFO_CACHE_SIZE - 1);
+  }
+
+  return NULL;
+}
+
+// key_info_cache_put records the key info for key, or that the key is missing
+// when key_info is NULL.
+static void key_info_cache_put(smc_handle_t *handle, smc_key_t key,
+                               const SMCKeyInfoData *key_info) {
+  uint32_t slot = key_info_cache_slot(key);
+
+  if (key == 0) {
+    return;
+  }
+
+  for (int i = 0; i < KEY_INFO_CACHE_SIZE; i++) {
+    key_info_entry_t *entry = &handle->key_info_cache[slot];
+    if (entry->key == key || entry->key == 0) {
+      entry->key = key;
+      if (key_info == NULL) {
+        entry->missing = 1;
+        memset(&entry->key_info, 0, sizeof(SMCKeyInfoData));
+      } else {
+        entry->missing = 0;
+        entry->key_info = *key_info;
+      }
+      return;
+    }
+    slot = (slot + 1) & (KEY_INFO_CACHE_SIZE - 1);
+  }
+
+  // The table is full; the key is simply looked up on every read.
+}
+
+// connect_smc opens the IOKit connection backing handle. Caches are tied to a
+// connection, so they are reset whenever it is (re)established.
+static smc_error_t connect_smc(smc_handle_t *handle) {
   kern_return_t result;
   io_service_t service;
 
@@ -74,50 +269,316 @@ kern_return_t open_smc(void) {
                                         IOServiceMatching(IOSERVICE_SMC));
   if (service == 0) {
     // Note: IOServiceMatching documents 0 on failure
-    printf("ERROR: %s NOT FOUND\n", IOSERVICE_SMC);
-    return kIOReturnError;
+    return log_error(SMC_ERR_SERVICE_NOT_FOUND, 0, kIOReturnNotFound,
+                     IOSERVICE_SMC " service not found");
   }
 
-  result = IOServiceOpen(service, mach_task_self(), 0, &conn);
+  memset(handle->key_info_cache, 0, sizeof(handle->key_info_cache));
+
+  result = IOServiceOpen(service, mach_task_self(), 0, &handle->conn);
   IOObjectRelease(service);
 
-  return result;
+  if (result != kIOReturnSuccess) {
+    handle->conn = MACH_PORT_NULL;
+    return log_error(SMC_ERR_OPEN_DENIED, 0, result,
+                     "failed to open " IOSERVICE_SMC " connection");
+  }
+
+  return SMC_OK;
 }
 
-kern_return_t close_smc(void) { return IOServiceClose(conn); }
+static void disconnect_smc(smc_handle_t *handle) {
+  if (handle->conn != MACH_PORT_NULL) {
+    IOServiceClose(handle->conn);
+    handle->conn = MACH_PORT_NULL;
+  }
+}
 
-static uint32_t to_uint32(char *key) {
-  uint32_t ans = 0;
-  uint32_t shift = 24;
+// connection_lost reports whether an IOKit call failed because the
+// connection went away, as happens to the SMC user client across sleep/wake.
+static int connection_lost(kern_return_t result) {
+  return result == kIOReturnNotOpen || result == kIOReturnNoDevice ||
+         result == MACH_SEND_INVALID_DEST;
+}
 
-  if (strlen(key) != SMC_KEY_SIZE) {
-    return 0;
+smc_error_t open_smc(smc_handle_t **handle) {
+  *handle = calloc(1, sizeof(smc_handle_t));
+  if (*handle == NULL) {
+    return log_error(SMC_ERR_NO_MEMORY, 0, kIOReturnNoMemory,
+                     "failed to allocate handle");
   }
 
+  // The connection itself is opened by the first call that needs it.
+  return SMC_OK;
+}
+
+smc_error_t close_smc(smc_handle_t *handle) {
+  if (handle == NULL) {
+    return SMC_OK;
+  }
+
+  disconnect_smc(handle);
+  hid_close(handle->hid);
+  free(handle);
+  return SMC_OK;
+}
+
+uint64_t smc_io_calls(smc_handle_t *handle) { return handle->io_calls; }
+
+void smc_flush_key_info(smc_handle_t *handle) {
+  memset(handle->key_info_cache, 0, sizeof(handle->key_info_cache));
+}
+
+void smc_drop_connection(smc_handle_t *handle) {
+  if (handle->conn != MACH_PORT_NULL) {
+    // Calls on a dead name fail with MACH_SEND_INVALID_DEST, while the name
+    // of the closed connection could be reused by another handle's.
+    IOServiceClose(handle->conn);
+    handle->conn = MACH_PORT_DEAD;
+  }
+}
+
+smc_key_t smc_key(const char *key) {
+  smc_key_t ans = 0;
+
   for (int i = 0; i < SMC_KEY_SIZE; i++) {
-    ans += key[i] << shift;
-    shift -= 8;
+    if (key[i] == '\0') {
+      return 0;
+    }
+    ans = (ans << 8) | (uint8_t)key[i];
+  }
+
+  if (key[SMC_KEY_SIZE] != '\0') {
+    return 0;
   }
 
   return ans;
 }
 
-static kern_return_t call_smc(SMCParamStruct *input, SMCParamStruct *output) {
+// The SMC reports each key's encoding as a four character data type. The
+// decoders below cover the fixed point (spXY signed, fpXY unsigned, with X
+// integer and Y fractional bits in hex), integer and float encodings.
+typedef enum {
+  DECODE_SIGNED_FIXED,
+  DECODE_UNSIGNED_FIXED,
+  DECODE_FLOAT,
+} decode_kind_t;
+
+typedef struct {
+  uint32_t data_type;
+  uint32_t data_size;
+  decode_kind_t kind;
+  uint8_t frac_bits;
+} smc_decoder_t;
+
+static const smc_decoder_t decoders[] = {
+    {SMC_KEY('s', 'p', '7', '8'), 2, DECODE_SIGNED_FIXED, 8},
+    {SMC_KEY('f', 'l', 't', ' '), 4, DECODE_FLOAT, 0},
+    {SMC_KEY('f', 'p', 'e', '2'), 2, DECODE_UNSIGNED_FIXED, 2},
+    {SMC_KEY('u', 'i', '8', ' '), 1, DECODE_UNSIGNED_FIXED, 0},
+    {SMC_KEY('u', 'i', '1', '6'), 2, DECODE_UNSIGNED_FIXED, 0},
+    {SMC_KEY('u', 'i', '3', '2'), 4, DECODE_UNSIGNED_FIXED, 0},
+    {SMC_KEY('s', 'i', '8', ' '), 1, DECODE_SIGNED_FIXED, 0},
+    {SMC_KEY('s', 'i', '1', '6'), 2, DECODE_SIGNED_FIXED, 0},
+    {SMC_KEY('s', 'i', '3', '2'), 4, DECODE_SIGNED_FIXED, 0},
+    {SMC_KEY('s', 'p', '1', 'e'), 2, DECODE_SIGNED_FIXED, 14},
+    {SMC_KEY('s', 'p', '3', 'c'), 2, DECODE_SIGNED_FIXED, 12},
+    {SMC_KEY('s', 'p', '4', 'b'), 2, DECODE_SIGNED_FIXED, 11},
+    {SMC_KEY('s', 'p', '5', 'a'), 2, DECODE_SIGNED_FIXED, 10},
+    {SMC_KEY('s', 'p', '6', '9'), 2, DECODE_SIGNED_FIXED, 9},
+    {SMC_KEY('s', 'p', '8', '7'), 2, DECODE_SIGNED_FIXED, 7},
+    {SMC_KEY('s', 'p', '9', '6'), 2, DECODE_SIGNED_FIXED, 6},
+    {SMC_KEY('s', 'p', 'a', '5'), 2, DECODE_SIGNED_FIXED, 5},
+    {SMC_KEY('s', 'p', 'b', '4'), 2, DECODE_SIGNED_FIXED, 4},
+    {SMC_KEY('s', 'p', 'f', '0'), 2, DECODE_SIGNED_FIXED, 0},
+    {SMC_KEY('f', 'p', '1', 'f'), 2, DECODE_UNSIGNED_FIXED, 15},
+    {SMC_KEY('f', 'p', '2', 'e'), 2, DECODE_UNSIGNED_FIXED, 14},
+    {SMC_KEY('f', 'p', '3', 'd'), 2, DECODE_UNSIGNED_FIXED, 13},
+    {SMC_KEY('f', 'p', '4', 'c'), 2, DECODE_UNSIGNED_FIXED, 12},
+    {SMC_KEY('f', 'p', '5', 'b'), 2, DECODE_UNSIGNED_FIXED, 11},
+    {SMC_KEY('f', 'p', '6', 'a'), 2, DECODE_UNSIGNED_FIXED, 10},
+    {SMC_KEY('f', 'p', '7', '9'), 2, DECODE_UNSIGNED_FIXED, 9},
+    {SMC_KEY('f', 'p', '8', '8'), 2, DECODE_UNSIGNED_FIXED, 8},
+    {SMC_KEY('f', 'p', 'a', '6'), 2, DECODE_UNSIGNED_FIXED, 6},
+    {SMC_KEY('f', 'p', 'c', '4'), 2, DECODE_UNSIGNED_FIXED, 4},
+};
+
+static const smc_decoder_t *find_decoder(uint32_t data_type) {
+  // The most common encodings sit at the front of the table.
+  for (size_t i = 0; i < sizeof(decoders) / sizeof(decoders[0]); i++) {
+    if (decoders[i].data_type == data_type) {
+      return &decoders[i];
+    }
+  }
+  return NULL;
+}
+
+int smc_decode(uint32_t data_type, uint32_t data_size, const uint8_t *bytes,
+               double *value) {
+  const smc_decoder_t *decoder = find_decoder(data_type);
+  uint32_t raw = 0;
+
+  if (decoder == NULL || decoder->data_size != data_size) {
+    return -1;
+  }
+
+  switch (decoder->kind) {
+  case DECODE_FLOAT: {
+    // flt values are stored in the host's (little-endian) byte order.
+    float f;
+    memcpy(&f, bytes, sizeof(f));
+    *value = (double)f;
+    return 0;
+  }
+  case DECODE_UNSIGNED_FIXED:
+  case DECODE_SIGNED_FIXED:
+    // Integer and fixed point values are big-endian.
+    for (uint32_t i = 0; i < data_size; i++) {
+      raw = (raw << 8) | bytes[i];
+    }
+    break;
+  }
+
+  if (decoder->kind == DECODE_SIGNED_FIXED) {
+    // Sign extend from the width of the value.
+    uint32_t shift = 32 - data_size * 8;
+    int32_t sraw = (int32_t)(raw << shift) >> shift;
+    *value = (double)sraw / (double)(1u << decoder->frac_bits);
+  } else {
+    *value = (double)raw / (double)(1u << decoder->frac_bits);
+  }
+
+  return 0;
+}
+
+static smc_error_t call_smc(smc_handle_t *handle, SMCParamStruct *input,
+                            SMCParamStruct *output) {
+  smc_error_t err;
   kern_return_t result;
+  uint64_t start_ns;
   size_t input_cnt = sizeof(SMCParamStruct);
   size_t output_cnt = sizeof(SMCParamStruct);
 
-  result = IOConnectCallStructMethod(conn, kSMCHandleYPCEvent, input, input_cnt,
-                                     output, &output_cnt);
+  if (handle->conn == MACH_PORT_NULL) {
+    err = connect_smc(handle);
+    if (err != SMC_OK) {
+      return err;
+    }
+  }
+
+  handle->io_calls++;
+  counter_inc(&stats.calls);
+  start_ns = uptime_ns();
+  result = IOConnectCallStructMethod(handle->conn, kSMCHandleYPCEvent, input,
+                                     input_cnt, output, &output_cnt);
+  histogram_observe(&stats.call_latency, start_ns);
+
+  if (connection_lost(result)) {
+    // Reconnect once and retry; a second failure is reported to the caller.
+    counter_inc(&stats.reconnects);
+    start_ns = uptime_ns();
+    disconnect_smc(handle);
+    err = connect_smc(handle);
+    histogram_observe(&stats.reconnect_latency, start_ns);
+    if (err != SMC_OK) {
+      return err;
+    }
+
+    output_cnt = sizeof(SMCParamStruct);
+    handle->io_calls++;
+    counter_inc(&stats.calls);
+    start_ns = uptime_ns();
+    result = IOConnectCallStructMethod(handle->conn, kSMCHandleYPCEvent, input,
+                                       input_cnt, output, &output_cnt);
+    histogram_observe(&stats.call_latency, start_ns);
+  }
 
   if (result != kIOReturnSuccess) {
-    result = err_get_code(result);
+    return log_error(SMC_ERR_IO, input->key, result, "SMC call failed");
   }
-  return result;
+  return SMC_OK;
 }
 
-static kern_return_t read_smc(char *key, smc_return_t *result_smc) {
-  kern_return_t result;
+// read_key reads a single encoded key using caller-provided parameter
+// structs so that batched reads can reuse them across keys. Only the fields
+// the SMC inspects are reset between calls. On success the value is in
+// output->bytes.
+static smc_error_t read_key(smc_handle_t *handle, smc_key_t key,
+                            SMCParamStruct *input, SMCParamStruct *output,
+                            smc_return_t *result_smc) {
+  smc_error_t err;
+  const key_info_entry_t *entry;
+  const SMCKeyInfoData *key_info;
+
+  result_smc->data_size = 0;
+  result_smc->data_type = 0;
+  result_smc->kSMC = kSMCError;
+
+  if (key == 0) {
+    result_smc->kSMC = kSMCKeyNotFound;
+    return SMC_ERR_KEY_MISSING;
+  }
+
+  input->key = key;
+  input->key_info.data_size = 0;
+
+  entry = key_info_cache_get(handle, key);
+  if (entry != NULL && entry->missing) {
+    counter_inc(&stats.missing_cached);
+    result_smc->kSMC = kSMCKeyNotFound;
+    return SMC_ERR_KEY_MISSING;
+  }
+
+  if (entry != NULL) {
+    key_info = &entry->key_info;
+  } else {
+    input->data8 = kSMCGetKeyInfo;
+
+    err = call_smc(handle, input, output);
+    if (err != SMC_OK) {
+      return err;
+    }
+
+    result_smc->kSMC = output->result;
+    if (output->result == kSMCKeyNotFound) {
+      counter_inc(&stats.key_not_found);
+      // Logged once; the negative cache answers for the key from now on.
+      key_info_cache_put(handle, key, NULL);
+      return log_error(SMC_ERR_KEY_MISSING, key, kIOReturnSuccess,
+                       "SMC key not found");
+    }
+    if (output->result != kSMCSuccess) {
+      return log_error(SMC_ERR_KEY_FAILED, key, kIOReturnSuccess,
+                       "SMC failed to get key info");
+    }
+
+    key_info_cache_put(handle, key, &output->key_info);
+    key_info = &output->key_info;
+  }
+
+  result_smc->data_size = key_info->data_size;
+  result_smc->data_type = key_info->data_type;
+
+  input->key_info.data_size = key_info->data_size;
+  input->data8 = kSMCReadKey;
+
+  err = call_smc(handle, input, output);
+  if (err != SMC_OK) {
+    return err;
+  }
+
+  result_smc->kSMC = output->result;
+  if (output->result != kSMCSuccess) {
+    return log_error(SMC_ERR_KEY_FAILED, key, kIOReturnSuccess,
+                     "SMC failed to read key");
+  }
+
+  return SMC_OK;
+}
+
+static smc_error_t read_smc(smc_handle_t *handle, smc_key_t key,
+                            smc_return_t *result_smc) {
+  smc_error_t err;
   SMCParamStruct input;
   SMCParamStruct output;
 
@@ -125,44 +586,398 @@ static kern_return_t read_smc(char *key, smc_return_t *result_smc) {
   memset(&output, 0, sizeof(SMCParamStruct));
   memset(result_smc, 0, sizeof(smc_return_t));
 
-  input.key = to_uint32(key);
-  input.data8 = kSMCGetKeyInfo;
+  err = read_key(handle, key, &input, &output, result_smc);
+  if (err != SMC_OK) {
+    return err;
+  }
 
-  result = call_smc(&input, &output);
-  result_smc->kSMC = output.result;
+  memcpy(result_smc->data, output.bytes, sizeof(output.bytes));
+
+  return SMC_OK;
+}
 
-  if (result != kIOReturnSuccess || output.result != kSMCSuccess) {
-    return result;
+// read_hid reads the HID sensor standing in for key.
+static smc_error_t read_hid(smc_handle_t *handle, smc_key_t key,
+                            double *value) {
+  *value = 0.0;
+
+  if (handle->hid == NULL) {
+    handle->hid = hid_open();
+    if (handle->hid == NULL) {
+      return log_error(SMC_ERR_SERVICE_NOT_FOUND, key, kIOReturnNotFound,
+                       "HID event system not available");
+    }
   }
 
-  result_smc->data_size = output.key_info.data_size;
-  result_smc->data_type = output.key_info.data_type;
+  if (hid_read_temperature(handle->hid, SMC_HID_INDEX(key), value) != 0) {
+    return SMC_ERR_KEY_MISSING;
+  }
+  return SMC_OK;
+}
+
+// read_value reads and decodes a single key for the batched reads, reusing
+// the caller's parameter structs.
+static smc_error_t read_value(smc_handle_t *handle, smc_key_t key,
+                              SMCParamStruct *input, SMCParamStruct *output,
+                              double *value) {
+  smc_error_t err;
+  smc_return_t result_smc;
 
-  input.key_info.data_size = output.key_info.data_size;
-  input.data8 = kSMCReadKey;
+  if (SMC_IS_HID_KEY(key)) {
+    return read_hid(handle, key, value);
+  }
 
-  result = call_smc(&input, &output);
-  result_smc->kSMC = output.result;
+  *value = 0.0;
 
-  if (result != kIOReturnSuccess || output.result != kSMCSuccess) {
-    return result;
+  err = read_key(handle, key, input, output, &result_smc);
+  if (err != SMC_OK) {
+    return err;
   }
 
-  memcpy(result_smc->data, output.bytes, sizeof(output.bytes));
+  if (smc_decode(result_smc.data_type, result_smc.data_size, output->bytes,
+                 value) != 0) {
+    *value = 0.0;
+    counter_inc(&stats.decode_failures);
+    return log_error(SMC_ERR_TYPE_MISMATCH, key, kIOReturnSuccess,
+                     "unsupported SMC data type");
+  }
 
-  return result;
+  return SMC_OK;
 }
 
-double get_temperature(char *key) {
-  kern_return_t result;
+smc_error_t read_smc_many(smc_handle_t *handle, const smc_key_t *keys,
+                          double *values, uint8_t *statuses, int count) {
+  smc_error_t err;
+  SMCParamStruct input;
+  SMCParamStruct output;
+
+  memset(&input, 0, sizeof(SMCParamStruct));
+  memset(&output, 0, sizeof(SMCParamStruct));
+
+  for (int i = 0; i < count; i++) {
+    err = read_value(handle, keys[i], &input, &output, &values[i]);
+    if (err != SMC_OK && !SMC_IS_KEY_ERROR(err)) {
+      // The connection itself failed; the remaining keys would fail the same
+      // way, so mark them as errors and give up on this batch.
+      for (int j = i; j < count; j++) {
+        statuses[j] = err;
+      }
+      return err;
+    }
+    statuses[i] = err;
+  }
+
+  return SMC_OK;
+}
+
+smc_error_t read_smc_readings(smc_handle_t *handle, smc_reading_t *readings,
+                              int count) {
+  smc_error_t err;
+  SMCParamStruct input;
+  SMCParamStruct output;
+
+  memset(&input, 0, sizeof(SMCParamStruct));
+  memset(&output, 0, sizeof(SMCParamStruct));
+
+  for (int i = 0; i < count; i++) {
+    err = read_value(handle, readings[i].key, &input, &output,
+                     &readings[i].value);
+    if (err != SMC_OK && !SMC_IS_KEY_ERROR(err)) {
+      for (int j = i; j < count; j++) {
+        readings[j].status = err;
+      }
+      return err;
+    }
+    readings[i].status = err;
+  }
+
+  return SMC_OK;
+}
+
+static int is_digit(uint8_t c) { return c >= '0' && c <= '9'; }
+
+// is_fractional reports whether values of data_type are readings rather than
+// counts or flags: flt, or a fixed point type with fractional bits.
+static int is_fractional(uint32_t data_type) {
+  const smc_decoder_t *decoder = find_decoder(data_type);
+
+  if (decoder == NULL) {
+    return 0;
+  }
+  return decoder->kind == DECODE_FLOAT || decoder->frac_bits > 0;
+}
+
+uint32_t smc_sensor_kind(smc_key_t key, uint32_t data_type) {
+  uint8_t prefix = (uint8_t)(key >> 24);
+
+  if (!is_fractional(data_type)) {
+    return 0;
+  }
+
+  switch (prefix) {
+  case 'T':
+    return SMC_SENSOR_TEMPERATURE;
+  case 'F':
+    // Of the per-fan keys only F<n>Ac is the actual speed; the others are
+    // targets and limits.
+    if (is_digit((uint8_t)(key >> 16)) && (key & 0xffff) == ('A' << 8 | 'c')) {
+      return SMC_SENSOR_FAN;
+    }
+    return 0;
+  case 'P':
+    return SMC_SENSOR_POWER;
+  case 'V':
+    return SMC_SENSOR_VOLTAGE;
+  default:
+    return 0;
+  }
+}
+
+// discover_hid writes up to max HID temperature sensors into sensors.
+static int discover_hid(smc_sensor_t *sensors, int max) {
+  int found = 0;
+
+  for (int i = 0; i < hid_sensor_count() && found < max; i++) {
+    sensors[found].key = SMC_HID_KEY(i);
+    snprintf(sensors[found].name, SMC_SENSOR_NAME_SIZE, "%s",
+             hid_sensor_name(i));
+    sensors[found].data_type = DATA_TYPE_HID;
+    sensors[found].data_size = sizeof(double);
+    sensors[found].kind = SMC_SENSOR_TEMPERATURE;
+    found++;
+  }
+
+  return found;
+}
+
+smc_error_t smc_discover_sensors(smc_handle_t *handle, uint32_t kinds,
+                                 smc_sensor_t *sensors, int max, int *found) {
+  smc_error_t err;
+  SMCParamStruct input;
+  SMCParamStruct output;
+  smc_return_t result_smc;
+  uint32_t count;
+  uint32_t kind;
+  uint8_t prefix;
+
+  *found = 0;
+
+  if ((kinds & SMC_SENSOR_TEMPERATURE) && smc_backend() == SMC_BACKEND_HID) {
+    *found = discover_hid(sensors, max);
+    kinds &= ~(uint32_t)SMC_SENSOR_TEMPERATURE;
+    if (kinds == 0) {
+      return SMC_OK;
+    }
+  }
+
+  memset(&input, 0, sizeof(SMCParamStruct));
+  memset(&output, 0, sizeof(SMCParamStruct));
+
+  err = read_key(handle, KEY_COUNT, &input, &output, &result_smc);
+  if (err != SMC_OK) {
+    // The HID sensors found so far are still usable without the SMC.
+    return *found > 0 ? SMC_OK : err;
+  }
+
+  // #KEY is a big-endian ui32.
+  count = ((uint32_t)output.bytes[0] << 24) | ((uint32_t)output.bytes[1] << 16) |
+          ((uint32_t)output.bytes[2] << 8) | (uint32_t)output.bytes[3];
+
+  for (uint32_t i = 0; i < count && *found < max; i++) {
+    memset(&input, 0, sizeof(SMCParamStruct));
+    input.data8 = kSMCGetKeyFromIndex;
+    input.data32 = i;
+
+    err = call_smc(handle, &input, &output);
+    if (err != SMC_OK) {
+      return err;
+    }
+    if (output.result != kSMCSuccess) {
+      continue;
+    }
+
+    // Skip keys outside the requested namespaces before paying for their
+    // key info.
+    prefix = (uint8_t)(output.key >> 24);
+    if (!((prefix == 'T' && (kinds & SMC_SENSOR_TEMPERATURE)) ||
+          (prefix == 'F' && (kinds & SMC_SENSOR_FAN)) ||
+          (prefix == 'P' && (kinds & SMC_SENSOR_POWER)) ||
+          (prefix == 'V' && (kinds & SMC_SENSOR_VOLTAGE)))) {
+      continue;
+    }
+
+    input.key = output.key;
+    input.data8 = kSMCGetKeyInfo;
+
+    err = call_smc(handle, &input, &output);
+    if (err != SMC_OK) {
+      return err;
+    }
+    if (output.result != kSMCSuccess) {
+      continue;
+    }
+
+    kind = smc_sensor_kind(input.key, output.key_info.data_type);
+    if ((kind & kinds) == 0 ||
+        find_decoder(output.key_info.data_type)->data_size !=
+            output.key_info.data_size) {
+      continue;
+    }
+
+    // Discovery already paid for the key info, so seed the cache with it.
+    key_info_cache_put(handle, input.key, &output.key_info);
+
+    sensors[*found].key = input.key;
+    for (int c = 0; c < SMC_KEY_SIZE; c++) {
+      sensors[*found].name[c] = (char)(input.key >> (8 * (SMC_KEY_SIZE - 1 - c)));
+    }
+    sensors[*found].name[SMC_KEY_SIZE] = '\0';
+    sensors[*found].data_type = output.key_info.data_type;
+    sensors[*found].data_size = (uint32_t)output.key_info.data_size;
+    sensors[*found].kind = kind;
+    (*found)++;
+  }
+
+  return SMC_OK;
+}
+
+smc_error_t smc_discover_temperatures(smc_handle_t *handle,
+                                      smc_sensor_t *sensors, int max,
+                                      int *found) {
+  return smc_discover_sensors(handle, SMC_SENSOR_TEMPERATURE, sensors, max,
+                              found);
+}
+
+smc_error_t smc_read_plimits(smc_handle_t *handle, smc_plimits_t *plimits) {
+  smc_error_t err;
+  SMCParamStruct input;
+  SMCParamStruct output;
+
+  memset(plimits, 0, sizeof(smc_plimits_t));
+  memset(&input, 0, sizeof(SMCParamStruct));
+  memset(&output, 0, sizeof(SMCParamStruct));
+
+  input.data8 = kSMCGetPLimits;
+
+  err = call_smc(handle, &input, &output);
+  if (err != SMC_OK) {
+    return err;
+  }
+  if (output.result != kSMCSuccess) {
+    return log_error(SMC_ERR_KEY_FAILED, 0, kIOReturnSuccess,
+                     "SMC failed to read performance limits");
+  }
+
+  plimits->cpu = output.p_limit_data.cpuPLimit;
+  plimits->gpu = output.p_limit_data.gpuPLimit;
+  plimits->mem = output.p_limit_data.memPLimit;
+  return SMC_OK;
+}
+
+smc_error_t smc_cpu_speed_limit(uint32_t *percent) {
+  CFDictionaryRef status = NULL;
+  CFNumberRef limit;
+  IOReturn result;
+  int value;
+
+  *percent = 100;
+
+  result = IOPMCopyCPUPowerStatus(&status);
+  if (result == kIOReturnNotFound) {
+    // Nothing has been published because the CPU was never limited.
+    return SMC_OK;
+  }
+  if (result != kIOReturnSuccess || status == NULL) {
+    return log_error(SMC_ERR_IO, 0, result, "failed to copy CPU power status");
+  }
+
+  limit = CFDictionaryGetValue(status,
+                               CFSTR(kIOPMCPUPowerLimitProcessorSpeedKey));
+  if (limit != NULL && CFGetTypeID(limit) == CFNumberGetTypeID() &&
+      CFNumberGetValue(limit, kCFNumberIntType, &value) && value >= 0) {
+    *percent = (uint32_t)value;
+  }
+
+  CFRelease(status);
+  return SMC_OK;
+}
+
+smc_error_t smc_platform_identity(char *model, size_t model_size, char *build,
+                                  size_t build_size) {
+  io_service_t service;
+  CFTypeRef property;
+  size_t length;
+
+  // Both strings need room for at least their terminator.
+  if (model == NULL || model_size == 0 || build == NULL || build_size == 0) {
+    return SMC_ERR_INVALID_ARGUMENT;
+  }
+
+  model[0] = '\0';
+  build[0] = '\0';
+
+  service = IOServiceGetMatchingService(kIOMasterPortDefault,
+                                        IOServiceMatching(IOSERVICE_MODEL));
+  if (service == 0) {
+    return log_error(SMC_ERR_SERVICE_NOT_FOUND, 0, kIOReturnNotFound,
+                     IOSERVICE_MODEL " service not found");
+  }
+
+  property = IORegistryEntryCreateCFProperty(service, CFSTR("model"),
+                                             kCFAllocatorDefault, 0);
+  IOObjectRelease(service);
+  if (property == NULL || CFGetTypeID(property) != CFDataGetTypeID()) {
+    if (property != NULL) {
+      CFRelease(property);
+    }
+    return log_error(SMC_ERR_IO, 0, kIOReturnNotFound,
+                     "failed to read the hardware model");
+  }
+
+  // The model is stored as C string bytes, usually including the NUL.
+  length = (size_t)CFDataGetLength((CFDataRef)property);
+  if (length > model_size - 1) {
+    length = model_size - 1;
+  }
+  memcpy(model, CFDataGetBytePtr((CFDataRef)property), length);
+  model[length] = '\0';
+  CFRelease(property);
+
+  length = build_size;
+  if (sysctlbyname("kern.osversion", build, &length, NULL, 0) != 0) {
+    build[0] = '\0';
+    return log_error(SMC_ERR_IO, 0, kIOReturnError,
+                     "failed to read the OS build");
+  }
+  build[build_size - 1] = '\0';
+
+  return SMC_OK;
+}
+
+double get_temperature_key(smc_handle_t *handle, smc_key_t key) {
   smc_return_t result_smc;
+  double value;
 
-  result = read_smc(key, &result_smc);
+  if (SMC_IS_HID_KEY(key)) {
+    read_hid(handle, key, &value);
+    return value;
+  }
+
+  if (read_smc(handle, key, &result_smc) != SMC_OK) {
+    return 0.0;
+  }
 
-  if (!(result == kIOReturnSuccess) && result_smc.data_size == 2 &&
-      result_smc.data_type == to_uint32(DATA_TYPE_SP78)) {
+  if (smc_decode(result_smc.data_type, result_smc.data_size, result_smc.data,
+                 &value) != 0) {
+    counter_inc(&stats.decode_failures);
+    log_error(SMC_ERR_TYPE_MISMATCH, key, kIOReturnSuccess,
+              "unsupported SMC data type");
     return 0.0;
   }
 
-  return (double)result_smc.data[0];
+  return value;
+}
+
+double get_temperature(smc_handle_t *handle, const char *key) {
+  return get_temperature_key(handle, smc_key(key));
 }
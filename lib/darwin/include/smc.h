@@ -25,8 +25,258 @@
 #define THUNDERBOLT_1          "TI1P"
 #define WIRELESS_MODULE        "TW0P"
 
-kern_return_t open_smc(void);
-kern_return_t close_smc(void);
-double get_temperature(char *);
+#define FAN_COUNT              "FNum"
+#define FAN_0_ACTUAL           "F0Ac"
+#define FAN_1_ACTUAL           "F1Ac"
+#define SYSTEM_POWER           "PSTR"
+#define CPU_PACKAGE_POWER      "PCPC"
+#define CPU_0_VOLTAGE          "VC0C"
+#define GPU_0_VOLTAGE          "VG0C"
+#define DC_IN_VOLTAGE          "VD0R"
+
+// smc_key_t is an SMC key encoded as its four characters packed big-endian.
+// Resolving keys once and passing the handle avoids re-encoding the string on
+// every read.
+typedef uint32_t smc_key_t;
+
+#define SMC_KEY(a, b, c, d)                                                    \
+  ((smc_key_t)(((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) |                 \
+               ((uint32_t)(c) << 8) | (uint32_t)(d)))
+
+#define SMC_KEY_AMBIENT_AIR_0          SMC_KEY('T', 'A', '0', 'P')
+#define SMC_KEY_AMBIENT_AIR_1          SMC_KEY('T', 'A', '1', 'P')
+#define SMC_KEY_CPU_0_DIODE            SMC_KEY('T', 'C', '0', 'D')
+#define SMC_KEY_CPU_0_HEATSINK         SMC_KEY('T', 'C', '0', 'H')
+#define SMC_KEY_CPU_0_PROXIMITY        SMC_KEY('T', 'C', '0', 'P')
+#define SMC_KEY_ENCLOSURE_BASE_0       SMC_KEY('T', 'B', '0', 'T')
+#define SMC_KEY_ENCLOSURE_BASE_1       SMC_KEY('T', 'B', '1', 'T')
+#define SMC_KEY_ENCLOSURE_BASE_2       SMC_KEY('T', 'B', '2', 'T')
+#define SMC_KEY_ENCLOSURE_BASE_3       SMC_KEY('T', 'B', '3', 'T')
+#define SMC_KEY_GPU_0_DIODE            SMC_KEY('T', 'G', '0', 'D')
+#define SMC_KEY_GPU_0_HEATSINK         SMC_KEY('T', 'G', '0', 'H')
+#define SMC_KEY_GPU_0_PROXIMITY        SMC_KEY('T', 'G', '0', 'P')
+#define SMC_KEY_HARD_DRIVE_BAY         SMC_KEY('T', 'H', '0', 'P')
+#define SMC_KEY_MEMORY_SLOT_0          SMC_KEY('T', 'M', '0', 'S')
+#define SMC_KEY_MEMORY_SLOTS_PROXIMITY SMC_KEY('T', 'M', '0', 'P')
+#define SMC_KEY_NORTHBRIDGE            SMC_KEY('T', 'N', '0', 'H')
+#define SMC_KEY_NORTHBRIDGE_DIODE      SMC_KEY('T', 'N', '0', 'D')
+#define SMC_KEY_NORTHBRIDGE_PROXIMITY  SMC_KEY('T', 'N', '0', 'P')
+#define SMC_KEY_THUNDERBOLT_0          SMC_KEY('T', 'I', '0', 'P')
+#define SMC_KEY_THUNDERBOLT_1          SMC_KEY('T', 'I', '1', 'P')
+#define SMC_KEY_WIRELESS_MODULE        SMC_KEY('T', 'W', '0', 'P')
+
+#define SMC_KEY_FAN_COUNT              SMC_KEY('F', 'N', 'u', 'm')
+#define SMC_KEY_FAN_0_ACTUAL           SMC_KEY('F', '0', 'A', 'c')
+#define SMC_KEY_FAN_1_ACTUAL           SMC_KEY('F', '1', 'A', 'c')
+#define SMC_KEY_SYSTEM_POWER           SMC_KEY('P', 'S', 'T', 'R')
+#define SMC_KEY_CPU_PACKAGE_POWER      SMC_KEY('P', 'C', 'P', 'C')
+#define SMC_KEY_CPU_0_VOLTAGE          SMC_KEY('V', 'C', '0', 'C')
+#define SMC_KEY_GPU_0_VOLTAGE          SMC_KEY('V', 'G', '0', 'C')
+#define SMC_KEY_DC_IN_VOLTAGE          SMC_KEY('V', 'D', '0', 'R')
+
+// SMC_HID_KEY is the key standing in for HID temperature sensor i when
+// sensors are read through the HID backend (see smc_backend). SMC keys are
+// ASCII, so they never have the top bit set.
+#define SMC_HID_KEY(i) ((smc_key_t)(0x80000000u | (uint32_t)(i)))
+#define SMC_IS_HID_KEY(key) (((key)&0x80000000u) != 0)
+#define SMC_HID_INDEX(key) ((int)((key)&0x7fffffffu))
+
+// smc_error_t is returned by every call that can fail. SMC_IS_KEY_ERROR
+// tells the errors that concern a single key apart from those that mean the
+// SMC could not be talked to at all.
+typedef enum {
+  SMC_OK = 0,
+  SMC_ERR_SERVICE_NOT_FOUND = 1, // there is no AppleSMC service.
+  SMC_ERR_OPEN_DENIED = 2,       // IOServiceOpen refused the connection.
+  SMC_ERR_IO = 3,                // an IOKit call on the connection failed.
+  SMC_ERR_NO_MEMORY = 4,
+  SMC_ERR_KEY_MISSING = 5,   // the SMC does not have the key.
+  SMC_ERR_KEY_FAILED = 6,    // the SMC refused to read the key.
+  SMC_ERR_TYPE_MISMATCH = 7, // the key's data type or size cannot be decoded.
+  SMC_ERR_INVALID_ARGUMENT = 8,
+} smc_error_t;
+
+#define SMC_IS_KEY_ERROR(err)                                                  \
+  ((err) >= SMC_ERR_KEY_MISSING && (err) <= SMC_ERR_TYPE_MISMATCH)
+
+// smc_log_fn receives every error as it happens, along with the key involved
+// (0 if none) and the raw IOKit result where there is one.
+typedef void (*smc_log_fn)(smc_error_t err, smc_key_t key, int32_t io_result,
+                           const char *msg);
+
+// smc_backend_t is where temperatures are read from.
+typedef enum {
+  SMC_BACKEND_SMC = 0, // AppleSMC T* keys.
+  SMC_BACKEND_HID = 1, // IOHID event system services, on Apple Silicon.
+} smc_backend_t;
+
+// smc_backend returns the backend temperatures are read from. It is chosen
+// by the first call and fixed for the life of the process: Apple Silicon
+// hosts with HID thermal sensors use the HID backend, others the SMC. Fans,
+// power, voltages and limits are always read from the SMC.
+smc_backend_t smc_backend(void);
+
+// smc_set_log_func registers fn to be called on errors, or disables logging
+// when fn is NULL. It must be called before any handle is in use.
+void smc_set_log_func(smc_log_fn fn);
+
+// smc_handle_t is an open connection to the SMC together with its key caches.
+// A handle must not be used by more than one thread at a time; threads that
+// read concurrently should each open their own.
+typedef struct smc_handle smc_handle_t;
+
+// open_smc creates a new handle and stores it in handle. The connection to the
+// SMC is opened lazily by the first read and kept for the life of the handle;
+// if it is lost (e.g. across sleep/wake) it is re-established transparently.
+// The handle must be released with close_smc.
+smc_error_t open_smc(smc_handle_t **handle);
+smc_error_t close_smc(smc_handle_t *handle);
+
+// smc_io_calls returns the number of IOKit calls made through handle since it
+// was opened, so that callers can measure what each read costs.
+uint64_t smc_io_calls(smc_handle_t *handle);
+
+// smc_flush_key_info drops every cached key info and missing key, so that the
+// next read of each key queries the SMC for its type and size again.
+void smc_flush_key_info(smc_handle_t *handle);
+
+// smc_drop_connection closes the connection of handle without forgetting it,
+// as happens to the SMC user client across sleep/wake, so that the next read
+// finds it lost and reconnects. It exists for the stress tests.
+void smc_drop_connection(smc_handle_t *handle);
+
+// smc_histogram_t counts durations in power-of-two buckets: buckets[i] holds
+// durations of at least 2^i and less than 2^(i+1) nanoseconds, with the last
+// bucket also holding everything longer.
+#define SMC_LATENCY_BUCKETS 32
+
+typedef struct {
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t buckets[SMC_LATENCY_BUCKETS];
+} smc_histogram_t;
+
+// smc_stats_t holds counters kept across every handle in the process since it
+// started. They are updated with relaxed atomics, so the fields of a copy may
+// be very slightly out of step with one another.
+typedef struct {
+  uint64_t calls;           // IOKit calls made by any handle.
+  uint64_t key_not_found;   // kSMCKeyNotFound answers from the SMC.
+  uint64_t missing_cached;  // reads answered from the missing key cache.
+  uint64_t reconnects;      // connections re-established after being lost.
+  uint64_t decode_failures; // values whose data type could not be decoded.
+  smc_histogram_t call_latency;
+  smc_histogram_t reconnect_latency;
+} smc_stats_t;
+
+// smc_get_stats copies the current counters into stats.
+void smc_get_stats(smc_stats_t *stats);
+
+// smc_plimits_t holds the performance limits the SMC currently imposes on the
+// CPU, GPU and memory. Each is 0 while the component is unrestricted; larger
+// values cap it to a lower performance state.
+typedef struct {
+  uint32_t cpu;
+  uint32_t gpu;
+  uint32_t mem;
+} smc_plimits_t;
+
+// smc_read_plimits reads the current performance limits into plimits.
+smc_error_t smc_read_plimits(smc_handle_t *handle, smc_plimits_t *plimits);
+
+// smc_cpu_speed_limit stores the percentage of its maximum speed that power
+// management currently lets the CPU run at in percent, which is 100 unless
+// the host is being throttled. It does not use the SMC connection and may be
+// called from any thread.
+smc_error_t smc_cpu_speed_limit(uint32_t *percent);
+
+// smc_platform_identity writes the hardware model of the host, such as
+// "MacBookPro18,3", and the build of the running OS, such as "22G91", into
+// model and build as NUL terminated strings. Together they identify a set of
+// SMC keys, so a discovered key table can be reused as long as neither
+// changes. It returns SMC_ERR_INVALID_ARGUMENT if either buffer is empty. It
+// does not use the SMC connection and may be called from any thread.
+smc_error_t smc_platform_identity(char *model, size_t model_size, char *build,
+                                  size_t build_size);
+
+double get_temperature(smc_handle_t *handle, const char *key);
+double get_temperature_key(smc_handle_t *handle, smc_key_t key);
+
+// smc_key encodes a four-character key name, returning 0 if the name is not
+// exactly four characters long.
+smc_key_t smc_key(const char *);
+
+// read_smc_many reads count keys in a single call. On return values[i] holds
+// the reading and statuses[i] the smc_error_t for keys[i]. Keys the SMC has
+// reported as missing since the handle was opened are answered with
+// SMC_ERR_KEY_MISSING without another IOKit call. If the connection fails
+// the remaining keys are given that error, which is also returned.
+smc_error_t read_smc_many(smc_handle_t *handle, const smc_key_t *keys,
+                          double *values, uint8_t *statuses, int count);
+
+// smc_reading_t is one entry of a batch read with read_smc_readings. Callers
+// set key once and reuse the array for every read.
+typedef struct {
+  smc_key_t key;
+  uint8_t status; // smc_error_t of the last read.
+  double value;
+} smc_reading_t;
+
+// read_smc_readings is read_smc_many over an array of smc_reading_t, so that
+// a caller can keep a single buffer of keys and results across reads.
+smc_error_t read_smc_readings(smc_handle_t *handle, smc_reading_t *readings,
+                              int count);
+
+// smc_decode converts the raw bytes of a key of the given SMC data type and
+// size into a value. It returns 0 on success and -1 if the type is not
+// supported or the size does not match the type.
+int smc_decode(uint32_t data_type, uint32_t data_size, const uint8_t *bytes,
+               double *value);
+
+// smc_sensor_kind_t is what a discovered key measures. The kinds are bits so
+// that discovery can be asked for several at once.
+typedef enum {
+  SMC_SENSOR_TEMPERATURE = 1 << 0, // T* keys, in °C.
+  SMC_SENSOR_FAN = 1 << 1,         // F<n>Ac keys, in RPM.
+  SMC_SENSOR_POWER = 1 << 2,       // P* keys, in W.
+  SMC_SENSOR_VOLTAGE = 1 << 3,     // V* keys, in V.
+} smc_sensor_kind_t;
+
+#define SMC_SENSOR_ALL                                                         \
+  (SMC_SENSOR_TEMPERATURE | SMC_SENSOR_FAN | SMC_SENSOR_POWER |                \
+   SMC_SENSOR_VOLTAGE)
+
+// SMC_SENSOR_NAME_SIZE is the size of a sensor's name, including the NUL.
+#define SMC_SENSOR_NAME_SIZE 32
+
+// smc_sensor_t describes a key found by smc_discover_sensors. name is the
+// key itself for SMC sensors and the product name for HID sensors, whose key
+// is an SMC_HID_KEY.
+typedef struct {
+  smc_key_t key;
+  char name[SMC_SENSOR_NAME_SIZE];
+  uint32_t data_type;
+  uint32_t data_size;
+  uint32_t kind; // smc_sensor_kind_t
+} smc_sensor_t;
+
+// smc_sensor_kind returns the kind of sensor a key of the given data type
+// measures, or 0 if it is not a sensor. Only fractional encodings (spXY, fpXY
+// and flt) are taken to be readings; integer keys under the same prefixes are
+// counts and flags.
+uint32_t smc_sensor_kind(smc_key_t key, uint32_t data_type);
+
+// smc_discover_sensors enumerates every key the SMC exposes and writes up to
+// max sensors of the given kinds into sensors, storing the number written in
+// found. With the HID backend, temperatures are the HID sensors instead of
+// the SMC's T* keys. Enumeration costs a few IOKit calls per key, so it is meant to run
+// once and have its result reused.
+smc_error_t smc_discover_sensors(smc_handle_t *handle, uint32_t kinds,
+                                 smc_sensor_t *sensors, int max, int *found);
+
+// smc_discover_temperatures is smc_discover_sensors for temperatures only.
+smc_error_t smc_discover_temperatures(smc_handle_t *handle,
+                                      smc_sensor_t *sensors, int max,
+                                      int *found);
 
 #endif // __SMC_H__
@@ -0,0 +1,32 @@
+#include "threshold.h"
+
+#include <math.h>
+
+int threshold_enabled(const smc_threshold_t *t) {
+  return !isnan(t->high) || !isnan(t->low);
+}
+
+smc_level_t threshold_level(const smc_threshold_t *t, smc_level_t level,
+                            float value) {
+  // Comparisons with NaN are false, so a failed read or a disabled
+  // watermark never changes the level.
+  if (isnan(value)) {
+    return level;
+  }
+
+  if (value >= t->high) {
+    return SMC_LEVEL_HIGH;
+  }
+  if (value <= t->low) {
+    return SMC_LEVEL_LOW;
+  }
+
+  switch (level) {
+  case SMC_LEVEL_HIGH:
+    return value < t->high - t->hysteresis ? SMC_LEVEL_NORMAL : level;
+  case SMC_LEVEL_LOW:
+    return value > t->low + t->hysteresis ? SMC_LEVEL_NORMAL : level;
+  default:
+    return level;
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef __THRESHOLD_H__
+#define __THRESHOLD_H__ 1
+
+#include <stdint.h>
+
+// smc_level_t is where a reading stands relative to its watermarks.
+typedef enum {
+  SMC_LEVEL_NORMAL = 0,
+  SMC_LEVEL_HIGH = 1,
+  SMC_LEVEL_LOW = 2,
+} smc_level_t;
+
+// smc_threshold_t holds the watermarks of one key. A reading at or above high
+// raises the key to SMC_LEVEL_HIGH, where it stays until a reading drops
+// below high - hysteresis; likewise a reading at or below low lowers it to
+// SMC_LEVEL_LOW until a reading rises above low + hysteresis. The hysteresis
+// keeps a reading hovering around a watermark from flapping. A NaN watermark
+// is disabled.
+typedef struct {
+  float high;
+  float low;
+  float hysteresis;
+} smc_threshold_t;
+
+// threshold_enabled reports whether t has any watermark.
+int threshold_enabled(const smc_threshold_t *t);
+
+// threshold_level returns the level of a key at level after reading value. A
+// NaN value, from a failed read, leaves the level as it is.
+smc_level_t threshold_level(const smc_threshold_t *t, smc_level_t level,
+                            float value);
+
+#endif // __THRESHOLD_H__
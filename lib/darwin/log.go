@@ -0,0 +1,62 @@
+package darwin
+
+import (
+	"sync"
+	"time"
+
+	hclog "github.com/hashicorp/go-hclog"
+)
+
+// logInterval is the minimum time between two log lines for the same error,
+// since a missing or broken sensor would otherwise log on every sample.
+const logInterval = time.Minute
+
+var (
+	logLock    sync.Mutex
+	logger     hclog.Logger = hclog.NewNullLogger()
+	lastLogged              = make(map[Error]time.Time)
+	suppressed              = make(map[Error]int)
+)
+
+// SetLogger sets the logger that errors reported by the native SMC layer are
+// written to at debug level.
+func SetLogger(l hclog.Logger) {
+	logLock.Lock()
+	defer logLock.Unlock()
+	logger = l
+}
+
+// currentLogger returns the logger set by SetLogger.
+func currentLogger() hclog.Logger {
+	logLock.Lock()
+	defer logLock.Unlock()
+	return logger
+}
+
+// logError logs an error reported by the native layer, rate limited per
+// error code.
+func logError(err Error, key uint32, ioResult int32, msg string) {
+	logLock.Lock()
+	defer logLock.Unlock()
+
+	now := time.Now()
+	if last, ok := lastLogged[err]; ok && now.Sub(last) < logInterval {
+		suppressed[err]++
+		return
+	}
+
+	args := []interface{}{"error", err, "message", msg}
+	if key != 0 {
+		args = append(args, "key", decodeKey(key))
+	}
+	if ioResult != 0 {
+		args = append(args, "io_result", hclog.Fmt("0x%x", uint32(ioResult)))
+	}
+	if n := suppressed[err]; n > 0 {
+		args = append(args, "suppressed", n)
+	}
+	logger.Debug("smc error", args...)
+
+	lastLogged[err] = now
+	delete(suppressed, err)
+}
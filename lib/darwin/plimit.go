@@ -0,0 +1,24 @@
+package darwin
+
+// PowerLimits are the limits the SMC and power management currently place on
+// the host's performance, usually because it is too hot or drawing too much
+// power. While they are in effect the CPU runs slower than its utilization
+// suggests.
+type PowerLimits struct {
+	// CPU, GPU and Memory are the SMC's performance limits for each
+	// component. They are 0 while the component is unrestricted; larger
+	// values cap it to a lower performance state.
+	CPU    uint32
+	GPU    uint32
+	Memory uint32
+
+	// SpeedLimit is the fraction of its maximum speed the CPU is allowed to
+	// run at, which is 1 unless it is being throttled.
+	SpeedLimit float64
+}
+
+// Throttled reports whether any component is being held below its full
+// performance.
+func (l *PowerLimits) Throttled() bool {
+	return l.CPU > 0 || l.GPU > 0 || l.Memory > 0 || l.SpeedLimit < 1
+}
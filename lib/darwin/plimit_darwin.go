@@ -0,0 +1,36 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include "smc.h"
+import "C"
+
+import "fmt"
+
+// ReadPowerLimits returns the performance limits currently in effect.
+func (s *SMC) ReadPowerLimits() (*PowerLimits, error) {
+	var plimits C.smc_plimits_t
+	var percent C.uint32_t
+
+	if ret := C.smc_cpu_speed_limit(&percent); ret != C.SMC_OK {
+		return nil, Error(ret)
+	}
+
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.handle == nil {
+		return nil, fmt.Errorf("smc: connection is closed")
+	}
+
+	if ret := C.smc_read_plimits(s.handle, &plimits); ret != C.SMC_OK {
+		return nil, Error(ret)
+	}
+
+	return &PowerLimits{
+		CPU:        uint32(plimits.cpu),
+		GPU:        uint32(plimits.gpu),
+		Memory:     uint32(plimits.mem),
+		SpeedLimit: float64(percent) / 100,
+	}, nil
+}
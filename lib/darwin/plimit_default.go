@@ -0,0 +1,8 @@
+// +build !darwin !cgo
+
+package darwin
+
+// ReadPowerLimits returns ErrNotSupported on this platform.
+func (s *SMC) ReadPowerLimits() (*PowerLimits, error) {
+	return nil, ErrNotSupported
+}
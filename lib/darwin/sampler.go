@@ -0,0 +1,140 @@
+package darwin
+
+import (
+	"math"
+	"time"
+)
+
+// SamplerConfig controls how often a Sampler reads its sensors. The sampler
+// starts at MinInterval and doubles its interval, up to MaxInterval, for every
+// pass in which each sensor varied by less than VarianceThreshold over its
+// recent history. As soon as any reading changes faster than RateThreshold
+// per second it returns to MinInterval.
+type SamplerConfig struct {
+	MinInterval time.Duration
+
+	// MaxInterval disables adaptation when it is not above MinInterval.
+	MaxInterval time.Duration
+
+	// VarianceThreshold and RateThreshold are in the unit of the sensors,
+	// e.g. °C² and °C/s for temperatures. Zero disables the check.
+	VarianceThreshold float64
+	RateThreshold     float64
+
+	// Workers is the number of threads, each with its own SMC connection,
+	// that read a share of the sensors in parallel, so that a pass takes as
+	// long as the slowest share. 0 or 1 reads every sensor in turn.
+	Workers int
+
+	// Window is the length of the consecutive windows the sampler aggregates
+	// each sensor over, rounded to milliseconds. Zero disables aggregates.
+	Window time.Duration
+
+	// EWMATimeConstant is the time constant of each sensor's exponentially
+	// weighted moving average. It defaults to Window.
+	EWMATimeConstant time.Duration
+}
+
+// Snapshot is a copy of one pass of a Sampler over its sensors. Values and OK
+// are indexed like the sensors the sampler was started with.
+type Snapshot struct {
+	// Sequence numbers snapshots from 1; it is 0 if nothing was sampled yet.
+	Sequence uint64
+
+	// Timestamp is when the sensors were read.
+	Timestamp time.Time
+
+	Values []float64
+	OK     []bool
+}
+
+// History is the recent readings of one sensor of a Sampler, oldest first, as
+// two parallel columns. Values holds NaN where a read failed.
+type History struct {
+	// Timestamps are nanoseconds since the Unix epoch.
+	Timestamps []int64
+	Values     []float32
+}
+
+// Aggregate summarizes the readings of one sensor over a window. Count is 0,
+// and so are Min, Max, Mean and P95, if every read in the window failed.
+type Aggregate struct {
+	Count int
+	Min   float64
+	Max   float64
+	Mean  float64
+
+	// P95 is estimated in constant space, so it is approximate.
+	P95 float64
+
+	// EWMA is the moving average at the end of the window, or NaN if the
+	// sensor was never read. It carries on across windows.
+	EWMA float64
+}
+
+// Aggregates is the last complete window of a Sampler. Sensors is indexed
+// like the sensors the sampler was started with.
+type Aggregates struct {
+	WindowStart time.Time
+	WindowEnd   time.Time
+	Sensors     []Aggregate
+}
+
+// Level is where a sensor's reading stands relative to its Threshold.
+type Level int
+
+const (
+	LevelNormal Level = iota
+	LevelHigh
+	LevelLow
+)
+
+func (l Level) String() string {
+	switch l {
+	case LevelNormal:
+		return "normal"
+	case LevelHigh:
+		return "high"
+	case LevelLow:
+		return "low"
+	default:
+		return "unknown"
+	}
+}
+
+// Threshold holds the watermarks of a sensor. A reading at or above High
+// raises the sensor to LevelHigh, where it stays until a reading drops below
+// High - Hysteresis; likewise a reading at or below Low lowers it to LevelLow
+// until a reading rises above Low + Hysteresis. A NaN watermark is disabled;
+// see DisabledThreshold.
+type Threshold struct {
+	High       float64
+	Low        float64
+	Hysteresis float64
+}
+
+// DisabledThreshold returns a Threshold with neither watermark set.
+func DisabledThreshold() Threshold {
+	return Threshold{High: math.NaN(), Low: math.NaN()}
+}
+
+// ThresholdEvent records a sensor of a Sampler moving from one Level to
+// another. Sensor is the sensor's index in the sensors the sampler was
+// started with.
+type ThresholdEvent struct {
+	Sensor    int
+	Timestamp time.Time
+	Level     Level
+	Previous  Level
+	Value     float64
+}
+
+// reset sizes the snapshot for n sensors, reusing its slices when possible.
+func (s *Snapshot) reset(n int) {
+	if cap(s.Values) < n {
+		s.Values = make([]float64, n)
+		s.OK = make([]bool, n)
+	}
+	s.Values = s.Values[:n]
+	s.OK = s.OK[:n]
+}
@@ -0,0 +1,272 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include "sampler.h"
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// snapshotBufs holds the native snapshots Latest copies out of, so that
+// concurrent calls neither share one nor allocate.
+var snapshotBufs = sync.Pool{
+	New: func() interface{} {
+		return new(C.smc_snapshot_t)
+	},
+}
+
+// Sampler reads a fixed set of sensors on a native background thread and
+// keeps the latest results in a lock-free ring buffer. Reading a snapshot
+// only copies memory; it never calls into the kernel.
+type Sampler struct {
+	// l guards aggregates, which Aggregates copies out of, and the history
+	// columns History copies out of. Latest does not take it.
+	l           sync.Mutex
+	aggregates  C.smc_aggregates_t
+	historyVals [C.SMC_SAMPLER_RING_SIZE]C.float
+	historyTime [C.SMC_SAMPLER_RING_SIZE]C.uint64_t
+	sampler     *C.smc_sampler_t
+	count       int
+
+	// waiters counts the calls blocked in WaitEvents without holding l,
+	// which Stop waits for before freeing the native sampler.
+	waiters sync.WaitGroup
+
+	// closed is set by Stop before it frees the native sampler, and readers
+	// counts the calls to Latest in progress, which Stop waits to drain.
+	// Latest only copies out of the ring, so the wait is short.
+	closed  int32
+	readers int32
+}
+
+// StartSampler starts sampling sensors as configured by config. The sampler
+// must be stopped with Stop.
+func StartSampler(sensors []Sensor, config SamplerConfig) (*Sampler, error) {
+	if len(sensors) > C.SMC_SAMPLER_MAX_SENSORS {
+		return nil, fmt.Errorf("smc: cannot sample more than %d sensors", C.SMC_SAMPLER_MAX_SENSORS)
+	}
+
+	var keys [C.SMC_SAMPLER_MAX_SENSORS]C.smc_key_t
+	for i, sensor := range sensors {
+		keys[i] = C.smc_key_t(sensor.key)
+	}
+
+	workers := config.Workers
+	if workers < 0 {
+		workers = 0
+	}
+
+	window, ewma := int64(0), int64(0)
+	if config.Window > 0 {
+		window = intervalMillis(config.Window)
+		ewma = window
+		if config.EWMATimeConstant > 0 {
+			ewma = intervalMillis(config.EWMATimeConstant)
+		}
+	}
+
+	cfg := C.smc_sampler_config_t{
+		min_interval_ms:    C.uint32_t(intervalMillis(config.MinInterval)),
+		max_interval_ms:    C.uint32_t(intervalMillis(config.MaxInterval)),
+		variance_threshold: C.double(config.VarianceThreshold),
+		rate_threshold:     C.double(config.RateThreshold),
+		workers:            C.uint32_t(workers),
+		window_ms:          C.uint32_t(window),
+		ewma_ms:            C.uint32_t(ewma),
+	}
+
+	s := &Sampler{count: len(sensors)}
+	ret := C.smc_sampler_start(&keys[0], C.int(len(sensors)), &cfg, &s.sampler)
+	if ret != C.SMC_OK {
+		return nil, Error(ret)
+	}
+	return s, nil
+}
+
+// intervalMillis converts d to the native sampler's resolution, rounding up
+// to at least a millisecond.
+func intervalMillis(d time.Duration) int64 {
+	ms := d.Milliseconds()
+	if ms < 1 {
+		ms = 1
+	}
+	return ms
+}
+
+// Interval returns how long the sampler currently waits between passes.
+func (s *Sampler) Interval() time.Duration {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.sampler == nil {
+		return 0
+	}
+	return time.Duration(C.smc_sampler_interval(s.sampler)) * time.Millisecond
+}
+
+// Stop stops the background thread and releases the sampler. Calls blocked
+// in WaitEvents return first.
+func (s *Sampler) Stop() {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.sampler == nil {
+		return
+	}
+	atomic.StoreInt32(&s.closed, 1)
+	for atomic.LoadInt32(&s.readers) != 0 {
+		runtime.Gosched()
+	}
+	C.smc_sampler_close_events(s.sampler)
+	s.waiters.Wait()
+	C.smc_sampler_stop(s.sampler)
+	s.sampler = nil
+}
+
+// SetThreshold sets the watermarks of the i-th sensor, which a disabled
+// threshold clears, and resets the sensor to LevelNormal.
+func (s *Sampler) SetThreshold(i int, t Threshold) error {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.sampler == nil {
+		return ErrNotSupported
+	}
+
+	threshold := C.smc_threshold_t{
+		high:       C.float(t.High),
+		low:        C.float(t.Low),
+		hysteresis: C.float(t.Hysteresis),
+	}
+	if ret := C.smc_sampler_set_threshold(s.sampler, C.int(i), &threshold); ret != C.SMC_OK {
+		return Error(ret)
+	}
+	return nil
+}
+
+// WaitEvents waits up to timeout for threshold events and appends them to
+// events, oldest first. It returns false once the sampler is stopped.
+func (s *Sampler) WaitEvents(events []ThresholdEvent, timeout time.Duration) ([]ThresholdEvent, bool) {
+	s.l.Lock()
+	sampler := s.sampler
+	if sampler == nil {
+		s.l.Unlock()
+		return events, false
+	}
+	s.waiters.Add(1)
+	s.l.Unlock()
+	defer s.waiters.Done()
+
+	var buf [C.SMC_SAMPLER_MAX_EVENTS]C.smc_threshold_event_t
+	n := int(C.smc_sampler_wait_events(sampler, &buf[0], C.SMC_SAMPLER_MAX_EVENTS, C.uint32_t(timeout.Milliseconds())))
+	if n < 0 {
+		return events, false
+	}
+
+	for _, event := range buf[:n] {
+		events = append(events, ThresholdEvent{
+			Sensor:    int(event.index),
+			Timestamp: time.Unix(0, int64(event.timestamp)),
+			Level:     Level(event.level),
+			Previous:  Level(event.previous),
+			Value:     float64(event.value),
+		})
+	}
+	return events, true
+}
+
+// DroppedEvents returns how many threshold events were dropped because
+// WaitEvents was not called often enough.
+func (s *Sampler) DroppedEvents() uint64 {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.sampler == nil {
+		return 0
+	}
+	return uint64(C.smc_sampler_events_dropped(s.sampler))
+}
+
+// Aggregates copies the aggregates of the last complete window into a,
+// reusing its slice. It returns false if aggregates are disabled or no window
+// has completed yet.
+func (s *Sampler) Aggregates(a *Aggregates) bool {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.sampler == nil || C.smc_sampler_aggregates(s.sampler, &s.aggregates) == 0 {
+		return false
+	}
+
+	if cap(a.Sensors) < s.count {
+		a.Sensors = make([]Aggregate, s.count)
+	}
+	a.Sensors = a.Sensors[:s.count]
+	a.WindowStart = time.Unix(0, int64(s.aggregates.window_start))
+	a.WindowEnd = time.Unix(0, int64(s.aggregates.window_end))
+	for i := 0; i < s.count; i++ {
+		key := &s.aggregates.keys[i]
+		a.Sensors[i] = Aggregate{
+			Count: int(key.count),
+			Min:   float64(key.min),
+			Max:   float64(key.max),
+			Mean:  float64(key.mean),
+			P95:   float64(key.p95),
+			EWMA:  float64(s.aggregates.ewma[i]),
+		}
+	}
+	return true
+}
+
+// History copies the readings of the i-th sensor still held by the sampler
+// into h, reusing its slices, and returns how many there were.
+func (s *Sampler) History(i int, h *History) int {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	h.Timestamps = h.Timestamps[:0]
+	h.Values = h.Values[:0]
+	if s.sampler == nil || i < 0 || i >= s.count {
+		return 0
+	}
+
+	n := int(C.smc_sampler_history(s.sampler, C.int(i), &s.historyVals[0], &s.historyTime[0]))
+	for j := 0; j < n; j++ {
+		h.Timestamps = append(h.Timestamps, int64(s.historyTime[j]))
+		h.Values = append(h.Values, float32(s.historyVals[j]))
+	}
+	return n
+}
+
+// Latest copies the most recent snapshot into snap, reusing its slices. It
+// returns false if the sampler has not completed a pass yet or is stopped.
+// Any number of goroutines may call Latest concurrently; they never wait on
+// each other.
+func (s *Sampler) Latest(snap *Snapshot) bool {
+	atomic.AddInt32(&s.readers, 1)
+	defer atomic.AddInt32(&s.readers, -1)
+	if atomic.LoadInt32(&s.closed) != 0 {
+		return false
+	}
+
+	buf := snapshotBufs.Get().(*C.smc_snapshot_t)
+	defer snapshotBufs.Put(buf)
+	if C.smc_sampler_latest(s.sampler, buf) == 0 {
+		return false
+	}
+
+	snap.reset(s.count)
+	snap.Sequence = uint64(buf.sequence)
+	snap.Timestamp = time.Unix(0, int64(buf.timestamp))
+	for i := 0; i < s.count; i++ {
+		snap.Values[i] = float64(buf.values[i])
+		snap.OK[i] = buf.statuses[i] == C.SMC_OK
+	}
+	return true
+}
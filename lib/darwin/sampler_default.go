@@ -0,0 +1,52 @@
+// +build !darwin !cgo
+
+package darwin
+
+import "time"
+
+// Sampler reads sensors on a background thread. It is not available on this
+// platform.
+type Sampler struct{}
+
+// StartSampler returns ErrNotSupported on this platform.
+func StartSampler(sensors []Sensor, config SamplerConfig) (*Sampler, error) {
+	return nil, ErrNotSupported
+}
+
+// Aggregates always returns false on this platform.
+func (s *Sampler) Aggregates(a *Aggregates) bool {
+	return false
+}
+
+// History always returns 0 on this platform.
+func (s *Sampler) History(i int, h *History) int {
+	return 0
+}
+
+// Interval always returns 0 on this platform.
+func (s *Sampler) Interval() time.Duration {
+	return 0
+}
+
+// Stop is a no-op on this platform.
+func (s *Sampler) Stop() {}
+
+// SetThreshold returns ErrNotSupported on this platform.
+func (s *Sampler) SetThreshold(i int, t Threshold) error {
+	return ErrNotSupported
+}
+
+// WaitEvents always returns false on this platform.
+func (s *Sampler) WaitEvents(events []ThresholdEvent, timeout time.Duration) ([]ThresholdEvent, bool) {
+	return events, false
+}
+
+// DroppedEvents always returns 0 on this platform.
+func (s *Sampler) DroppedEvents() uint64 {
+	return 0
+}
+
+// Latest always returns false on this platform.
+func (s *Sampler) Latest(snap *Snapshot) bool {
+	return false
+}
@@ -0,0 +1,148 @@
+// Package darwin provides access to hardware sensors on macOS through the
+// System Management Controller (SMC).
+package darwin
+
+import (
+	"errors"
+	"fmt"
+)
+
+// ErrNotSupported is returned on platforms or builds without SMC access.
+var ErrNotSupported = errors.New("smc: not supported on this platform")
+
+// Error is an error code reported by the native SMC layer. The values match
+// smc_error_t in smc.h.
+type Error int
+
+const (
+	ErrServiceNotFound Error = 1
+	ErrOpenDenied      Error = 2
+	ErrIO              Error = 3
+	ErrNoMemory        Error = 4
+	ErrKeyMissing      Error = 5
+	ErrKeyFailed       Error = 6
+	ErrTypeMismatch    Error = 7
+	ErrInvalidArgument Error = 8
+)
+
+func (e Error) Error() string {
+	switch e {
+	case ErrServiceNotFound:
+		return "smc: AppleSMC service not found"
+	case ErrOpenDenied:
+		return "smc: failed to open AppleSMC connection"
+	case ErrIO:
+		return "smc: IOKit call failed"
+	case ErrNoMemory:
+		return "smc: out of memory"
+	case ErrKeyMissing:
+		return "smc: key not found"
+	case ErrKeyFailed:
+		return "smc: failed to read key"
+	case ErrTypeMismatch:
+		return "smc: unsupported data type"
+	case ErrInvalidArgument:
+		return "smc: invalid argument"
+	default:
+		return fmt.Sprintf("smc: unknown error %d", int(e))
+	}
+}
+
+// SensorKind is what a sensor measures. The values match smc_sensor_kind_t in
+// smc.h.
+type SensorKind uint32
+
+const (
+	// KindTemperature sensors read in degrees Celsius.
+	KindTemperature SensorKind = 1 << 0
+
+	// KindFan sensors read the actual speed of a fan in RPM.
+	KindFan SensorKind = 1 << 1
+
+	// KindPower sensors read in watts, e.g. PSTR for the whole system and
+	// PCPC for the CPU package.
+	KindPower SensorKind = 1 << 2
+
+	// KindVoltage sensors read in volts.
+	KindVoltage SensorKind = 1 << 3
+)
+
+func (k SensorKind) String() string {
+	switch k {
+	case KindTemperature:
+		return "temperature"
+	case KindFan:
+		return "fan"
+	case KindPower:
+		return "power"
+	case KindVoltage:
+		return "voltage"
+	default:
+		return fmt.Sprintf("unknown(%d)", uint32(k))
+	}
+}
+
+// FilterSensors returns the sensors of the given kind, in the order given.
+func FilterSensors(sensors []Sensor, kind SensorKind) []Sensor {
+	filtered := make([]Sensor, 0, len(sensors))
+	for _, sensor := range sensors {
+		if sensor.Kind == kind {
+			filtered = append(filtered, sensor)
+		}
+	}
+	return filtered
+}
+
+// Backend is where temperatures are read from, chosen once per process.
+type Backend string
+
+const (
+	// BackendSMC reads temperatures from AppleSMC keys.
+	BackendSMC Backend = "smc"
+
+	// BackendHID reads temperatures from the IOHID event system, which is
+	// where Apple Silicon hosts publish most of their thermal sensors.
+	BackendHID Backend = "hid"
+)
+
+// Sensor describes an SMC key discovered on the host.
+type Sensor struct {
+	// Key is the four character SMC key, e.g. "TC0P", or the product name of
+	// a HID sensor, e.g. "PMU tdie1".
+	Key string
+
+	// Kind is what the sensor measures.
+	Kind SensorKind
+
+	// Type is the four character SMC data type, e.g. "sp78", or "hid " for
+	// HID sensors.
+	Type string
+
+	// Size is the number of bytes the key's value occupies.
+	Size uint32
+
+	// key is the encoded form of Key passed to the native reader.
+	key uint32
+}
+
+// encodeKey packs a four character SMC key or data type big-endian, matching
+// the SMC_KEY macro in smc.h.
+func encodeKey(s string) uint32 {
+	if len(s) != 4 {
+		return 0
+	}
+	return uint32(s[0])<<24 | uint32(s[1])<<16 | uint32(s[2])<<8 | uint32(s[3])
+}
+
+// hidKeyFlag marks the keys standing in for HID sensors, see SMC_HID_KEY in
+// smc.h.
+const hidKeyFlag = 0x80000000
+
+// decodeKey is the inverse of encodeKey. Keys of HID sensors have no
+// characters of their own and are shown by index.
+func decodeKey(k uint32) string {
+	if k&hidKeyFlag != 0 {
+		return fmt.Sprintf("hid%d", k&^hidKeyFlag)
+	}
+	return string([]byte{byte(k >> 24), byte(k >> 16), byte(k >> 8), byte(k)})
+}
@@ -0,0 +1,130 @@
+// +build darwin,cgo
+
+package darwin
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+)
+
+// headerKeys are the temperature keys declared in smc.h. Not every host has
+// all of them; missing keys are part of what is being measured.
+var headerKeys = []string{
+	"TA0P", "TA1P", "TC0D", "TC0H", "TC0P", "TB0T", "TB1T", "TB2T", "TB3T",
+	"TG0D", "TG0H", "TG0P", "TH0P", "TM0S", "TM0P", "TN0H", "TN0D", "TN0P",
+	"TI0P", "TI1P", "TW0P",
+}
+
+// benchSMC opens a connection for b and warms it up with one read of every
+// key, so that the connection and key info caches are in their steady state
+// before the timer starts.
+func benchSMC(b *testing.B) (*SMC, []benchKey) {
+	s, err := Open()
+	require.NoError(b, err)
+	keys := newBenchKeys(headerKeys)
+	b.Cleanup(func() {
+		s.Close()
+		freeBenchKeys(keys)
+	})
+
+	for _, k := range keys {
+		s.getTemperatureKey(k)
+	}
+	return s, keys
+}
+
+// reportIOCalls starts the timer and reports the IOKit calls s makes per
+// iteration of run.
+func reportIOCalls(b *testing.B, s *SMC, run func()) {
+	b.ReportAllocs()
+	start := s.ioCalls()
+	b.ResetTimer()
+	run()
+	b.StopTimer()
+	b.ReportMetric(float64(s.ioCalls()-start)/float64(b.N), "iokit-calls/op")
+}
+
+func BenchmarkSMC_Open(b *testing.B) {
+	keys := newBenchKeys(headerKeys[:1])
+	defer freeBenchKeys(keys)
+
+	var calls uint64
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		// The connection is opened lazily, so a read is needed to pay for it.
+		s, err := Open()
+		require.NoError(b, err)
+		s.getTemperatureKey(keys[0])
+		calls += s.ioCalls()
+		s.Close()
+	}
+	b.ReportMetric(float64(calls)/float64(b.N), "iokit-calls/op")
+}
+
+func BenchmarkSMC_GetTemperature(b *testing.B) {
+	s, keys := benchSMC(b)
+	k := keys[4] // TC0P, present on most Intel hosts.
+	reportIOCalls(b, s, func() {
+		for i := 0; i < b.N; i++ {
+			s.getTemperature(k)
+		}
+	})
+}
+
+func BenchmarkSMC_GetTemperature_Uncached(b *testing.B) {
+	s, keys := benchSMC(b)
+	k := keys[4]
+	reportIOCalls(b, s, func() {
+		for i := 0; i < b.N; i++ {
+			s.flushKeyInfo()
+			s.getTemperatureKey(k)
+		}
+	})
+}
+
+func BenchmarkSMC_GetTemperature_AllKeys(b *testing.B) {
+	s, keys := benchSMC(b)
+	reportIOCalls(b, s, func() {
+		for i := 0; i < b.N; i++ {
+			for _, k := range keys {
+				s.getTemperatureKey(k)
+			}
+		}
+	})
+}
+
+func BenchmarkSMC_ReadSensors_AllKeys(b *testing.B) {
+	s, _ := benchSMC(b)
+	sensors := make([]Sensor, len(headerKeys))
+	for i, key := range headerKeys {
+		sensors[i] = Sensor{Key: key, key: encodeKey(key)}
+	}
+	values := make([]float64, len(sensors))
+	ok := make([]bool, len(sensors))
+
+	reportIOCalls(b, s, func() {
+		for i := 0; i < b.N; i++ {
+			require.NoError(b, s.ReadSensors(sensors, values, ok))
+		}
+	})
+}
+
+func BenchmarkSMC_ReadBatch_AllKeys(b *testing.B) {
+	s, _ := benchSMC(b)
+	sensors := make([]Sensor, len(headerKeys))
+	for i, key := range headerKeys {
+		sensors[i] = Sensor{Key: key, key: encodeKey(key)}
+	}
+	batch, err := NewBatch(sensors)
+	require.NoError(b, err)
+	defer batch.Free()
+
+	reportIOCalls(b, s, func() {
+		for i := 0; i < b.N; i++ {
+			if err := s.ReadBatch(batch); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,282 @@
+// +build darwin,cgo
+
+package darwin
+
+/*
+#cgo CFLAGS: -I${SRCDIR}/include
+#cgo LDFLAGS: -framework IOKit -framework CoreFoundation
+#include "smc.h"
+
+extern void goSMCLog(smc_error_t, smc_key_t, int32_t, char *);
+
+static void smc_log_trampoline(smc_error_t err, smc_key_t key,
+                               int32_t io_result, const char *msg) {
+  goSMCLog(err, key, io_result, (char *)msg);
+}
+
+static void smc_register_log(void) { smc_set_log_func(smc_log_trampoline); }
+*/
+import "C"
+
+import (
+	"fmt"
+	"sync"
+)
+
+// maxSensors bounds the number of sensors returned by discovery.
+const maxSensors = 256
+
+func init() {
+	C.smc_register_log()
+}
+
+var (
+	// sensorDiscovery memoizes the sensors found by discover for Sensors
+	// and DiscoverSensors.
+	sensorDiscovery = newDiscovery(discover)
+)
+
+// SMC is a connection to the System Management Controller. Every SMC owns a
+// separate native handle and key caches, so independent readers never
+// contend with one another.
+type SMC struct {
+	// l serializes use of the handle, which the native layer does not allow
+	// to be shared between threads.
+	l      sync.Mutex
+	handle *C.smc_handle_t
+}
+
+// Open returns a new connection to the SMC, which must be released with
+// Close. The underlying IOKit connection is established by the first read and
+// re-established transparently if it is lost, so an SMC is meant to be kept
+// for as long as its owner samples sensors.
+func Open() (*SMC, error) {
+	s := &SMC{}
+	if ret := C.open_smc(&s.handle); ret != C.SMC_OK {
+		return nil, Error(ret)
+	}
+	return s, nil
+}
+
+// Close releases the connection to the SMC.
+func (s *SMC) Close() error {
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.handle == nil {
+		return nil
+	}
+	ret := C.close_smc(s.handle)
+	s.handle = nil
+	if ret != C.SMC_OK {
+		return Error(ret)
+	}
+	return nil
+}
+
+// Sensors returns the temperature, fan, power and voltage sensors present on
+// this host. The SMC key space is enumerated on the first successful call
+// only; the result is reused for the life of the process since the set of
+// keys cannot change while the machine is booted. A failed discovery is
+// returned until a backoff has passed and is then attempted again. With a
+// discovery cache set, the result is also reused across processes; see
+// SetDiscoveryCache.
+func Sensors() ([]Sensor, error) {
+	return sensorDiscovery.Sensors()
+}
+
+// discover finds the sensors of the host, from the discovery cache when it
+// was saved on this platform.
+func discover() ([]Sensor, error) {
+	path := discoveryCachePath()
+	identity, err := readPlatformIdentity()
+	if err != nil {
+		path = ""
+	}
+
+	var cached []Sensor
+	if path != "" {
+		cached, _ = loadDiscoveryCache(path, identity)
+	}
+
+	s, err := Open()
+	if err != nil {
+		return nil, err
+	}
+	defer s.Close()
+
+	if cached != nil {
+		// HID sensors are never cached, and finding them does not
+		// enumerate the SMC.
+		if identity.Backend != BackendHID {
+			return cached, nil
+		}
+		sensors, err := s.enumerate(C.SMC_SENSOR_TEMPERATURE)
+		if err != nil {
+			return nil, err
+		}
+		return append(sensors, cached...), nil
+	}
+
+	sensors, err := s.enumerate(C.SMC_SENSOR_ALL)
+	if err != nil {
+		return nil, err
+	}
+
+	if path != "" {
+		if err := saveDiscoveryCache(path, identity, sensors); err != nil {
+			currentLogger().Warn("failed to save sensor discovery cache", "path", path, "error", err)
+		}
+	}
+	return sensors, nil
+}
+
+// enumerate returns the sensors of the given kinds found by walking the SMC
+// key space.
+func (s *SMC) enumerate(kinds C.uint32_t) ([]Sensor, error) {
+	var sensors [maxSensors]C.smc_sensor_t
+	var n C.int
+	ret := C.smc_discover_sensors(s.handle, kinds, &sensors[0], C.int(len(sensors)), &n)
+	if ret != C.SMC_OK {
+		return nil, fmt.Errorf("smc: failed to enumerate keys: %w", Error(ret))
+	}
+
+	found := make([]Sensor, 0, int(n))
+	for _, sensor := range sensors[:int(n)] {
+		found = append(found, Sensor{
+			Key:  C.GoString(&sensor.name[0]),
+			Kind: SensorKind(sensor.kind),
+			Type: decodeKey(uint32(sensor.data_type)),
+			Size: uint32(sensor.data_size),
+			key:  uint32(sensor.key),
+		})
+	}
+	return found, nil
+}
+
+// readPlatformIdentity returns the identity the discovery cache is validated
+// against.
+func readPlatformIdentity() (platformIdentity, error) {
+	var model [64]C.char
+	var build [32]C.char
+	ret := C.smc_platform_identity(&model[0], C.size_t(len(model)), &build[0], C.size_t(len(build)))
+	if ret != C.SMC_OK {
+		return platformIdentity{}, Error(ret)
+	}
+
+	return platformIdentity{
+		Model:   C.GoString(&model[0]),
+		OSBuild: C.GoString(&build[0]),
+		Backend: SelectedBackend(),
+	}, nil
+}
+
+// DiscoverSensors returns the result of Sensors without waiting for it. The
+// first call starts discovery in the background, and every call returns
+// pending until it has completed, so that callers on a latency sensitive path
+// never wait for the key space to be enumerated. After a failed discovery the
+// failure is returned until its backoff has passed, and the next call then
+// starts another attempt in the background.
+func DiscoverSensors() (sensors []Sensor, pending bool, err error) {
+	return sensorDiscovery.Start()
+}
+
+// SelectedBackend returns the backend temperatures are read from. It is
+// chosen by the first call, which on Apple Silicon enumerates the HID sensors,
+// and fixed for the life of the process after that.
+func SelectedBackend() Backend {
+	if C.smc_backend() == C.SMC_BACKEND_HID {
+		return BackendHID
+	}
+	return BackendSMC
+}
+
+// TemperatureSensors returns the temperature sensors present on this host.
+func TemperatureSensors() ([]Sensor, error) {
+	return sensorsOfKind(KindTemperature)
+}
+
+// FanSensors returns the fan speed sensors present on this host.
+func FanSensors() ([]Sensor, error) {
+	return sensorsOfKind(KindFan)
+}
+
+// PowerSensors returns the power sensors present on this host.
+func PowerSensors() ([]Sensor, error) {
+	return sensorsOfKind(KindPower)
+}
+
+// VoltageSensors returns the voltage sensors present on this host.
+func VoltageSensors() ([]Sensor, error) {
+	return sensorsOfKind(KindVoltage)
+}
+
+func sensorsOfKind(kind SensorKind) ([]Sensor, error) {
+	sensors, err := Sensors()
+	if err != nil {
+		return nil, err
+	}
+	return FilterSensors(sensors, kind), nil
+}
+
+// FanCount returns the number of fans the SMC reports (FNum), which is 0 on
+// fanless hosts.
+func (s *SMC) FanCount() (int, error) {
+	key := C.smc_key_t(C.SMC_KEY_FAN_COUNT)
+	var value C.double
+	var status C.uint8_t
+
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.handle == nil {
+		return 0, fmt.Errorf("smc: connection is closed")
+	}
+
+	if ret := C.read_smc_many(s.handle, &key, &value, &status, 1); ret != C.SMC_OK {
+		return 0, Error(ret)
+	}
+	switch status {
+	case C.SMC_OK:
+		return int(value), nil
+	case C.SMC_ERR_KEY_MISSING:
+		return 0, nil
+	default:
+		return 0, Error(status)
+	}
+}
+
+// ReadSensors reads the given sensors with a single native call and stores
+// the readings, in the unit of each sensor's kind, into values. ok[i] reports
+// whether sensors[i] was read successfully. Both values and ok must be at
+// least as long as sensors.
+func (s *SMC) ReadSensors(sensors []Sensor, values []float64, ok []bool) error {
+	if len(sensors) == 0 {
+		return nil
+	}
+
+	keys := make([]C.smc_key_t, len(sensors))
+	readings := make([]C.double, len(sensors))
+	statuses := make([]C.uint8_t, len(sensors))
+	for i, sensor := range sensors {
+		keys[i] = C.smc_key_t(sensor.key)
+	}
+
+	s.l.Lock()
+	defer s.l.Unlock()
+
+	if s.handle == nil {
+		return fmt.Errorf("smc: connection is closed")
+	}
+
+	ret := C.read_smc_many(s.handle, &keys[0], &readings[0], &statuses[0], C.int(len(keys)))
+	if ret != C.SMC_OK {
+		return Error(ret)
+	}
+
+	for i := range sensors {
+		values[i] = float64(readings[i])
+		ok[i] = statuses[i] == C.SMC_OK
+	}
+	return nil
+}
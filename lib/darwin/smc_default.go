@@ -0,0 +1,63 @@
+// +build !darwin !cgo
+
+package darwin
+
+// SMC is a connection to the System Management Controller. It is not
+// available on this platform.
+type SMC struct{}
+
+// Open returns ErrNotSupported on this platform.
+func Open() (*SMC, error) {
+	return nil, ErrNotSupported
+}
+
+// Close returns ErrNotSupported on this platform.
+func (s *SMC) Close() error {
+	return ErrNotSupported
+}
+
+// Sensors returns ErrNotSupported on this platform.
+func Sensors() ([]Sensor, error) {
+	return nil, ErrNotSupported
+}
+
+// DiscoverSensors returns ErrNotSupported on this platform.
+func DiscoverSensors() ([]Sensor, bool, error) {
+	return nil, false, ErrNotSupported
+}
+
+// SelectedBackend returns BackendSMC on this platform, where no backend is
+// available.
+func SelectedBackend() Backend {
+	return BackendSMC
+}
+
+// TemperatureSensors returns ErrNotSupported on this platform.
+func TemperatureSensors() ([]Sensor, error) {
+	return nil, ErrNotSupported
+}
+
+// FanSensors returns ErrNotSupported on this platform.
+func FanSensors() ([]Sensor, error) {
+	return nil, ErrNotSupported
+}
+
+// PowerSensors returns ErrNotSupported on this platform.
+func PowerSensors() ([]Sensor, error) {
+	return nil, ErrNotSupported
+}
+
+// VoltageSensors returns ErrNotSupported on this platform.
+func VoltageSensors() ([]Sensor, error) {
+	return nil, ErrNotSupported
+}
+
+// FanCount returns ErrNotSupported on this platform.
+func (s *SMC) FanCount() (int, error) {
+	return 0, ErrNotSupported
+}
+
+// ReadSensors returns ErrNotSupported on this platform.
+func (s *SMC) ReadSensors(sensors []Sensor, values []float64, ok []bool) error {
+	return ErrNotSupported
+}
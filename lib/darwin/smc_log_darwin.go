@@ -0,0 +1,12 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include "smc.h"
+import "C"
+
+// goSMCLog is registered as the native log callback in init.
+//export goSMCLog
+func goSMCLog(code C.smc_error_t, key C.smc_key_t, ioResult C.int32_t, msg *C.char) {
+	logError(Error(code), uint32(key), int32(ioResult), C.GoString(msg))
+}
@@ -0,0 +1,67 @@
+package darwin
+
+import (
+	"bytes"
+	"testing"
+	"time"
+
+	hclog "github.com/hashicorp/go-hclog"
+	"github.com/stretchr/testify/require"
+)
+
+func TestSMC_EncodeKey(t *testing.T) {
+	require.Equal(t, uint32(0x54433050), encodeKey("TC0P"))
+	require.Equal(t, uint32(0x666c7420), encodeKey("flt "))
+	require.Zero(t, encodeKey("TC0"))
+	require.Zero(t, encodeKey("TC0PX"))
+
+	require.Equal(t, "TC0P", decodeKey(encodeKey("TC0P")))
+	require.Equal(t, "sp78", decodeKey(encodeKey("sp78")))
+	require.Equal(t, "hid3", decodeKey(hidKeyFlag|3))
+}
+
+func TestSMC_LogError_RateLimited(t *testing.T) {
+	var buf bytes.Buffer
+	SetLogger(hclog.New(&hclog.LoggerOptions{
+		Level:  hclog.Debug,
+		Output: &buf,
+	}))
+	defer SetLogger(hclog.NewNullLogger())
+
+	logError(ErrKeyMissing, encodeKey("TC0P"), 0, "SMC key not found")
+	logError(ErrKeyMissing, encodeKey("TC1P"), 0, "SMC key not found")
+	logError(ErrIO, 0, -536870195, "SMC call failed")
+
+	out := buf.String()
+	require.Contains(t, out, "key=TC0P")
+	require.NotContains(t, out, "key=TC1P")
+	require.Contains(t, out, "io_result=0xe00002cd")
+}
+
+func TestStats_BucketBound(t *testing.T) {
+	require.Equal(t, 2*time.Nanosecond, BucketBound(0))
+	require.Equal(t, 1024*time.Nanosecond, BucketBound(9))
+}
+
+func TestSMC_FilterSensors(t *testing.T) {
+	sensors := []Sensor{
+		{Key: "TC0P", Kind: KindTemperature},
+		{Key: "F0Ac", Kind: KindFan},
+		{Key: "PSTR", Kind: KindPower},
+		{Key: "TG0P", Kind: KindTemperature},
+	}
+
+	temps := FilterSensors(sensors, KindTemperature)
+	require.Len(t, temps, 2)
+	require.Equal(t, "TC0P", temps[0].Key)
+	require.Equal(t, "TG0P", temps[1].Key)
+
+	require.Empty(t, FilterSensors(sensors, KindVoltage))
+	require.Equal(t, "fan", KindFan.String())
+}
+
+func TestPowerLimits_Throttled(t *testing.T) {
+	require.False(t, (&PowerLimits{SpeedLimit: 1}).Throttled())
+	require.True(t, (&PowerLimits{CPU: 2, SpeedLimit: 1}).Throttled())
+	require.True(t, (&PowerLimits{SpeedLimit: 0.6}).Throttled())
+}
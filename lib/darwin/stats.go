@@ -0,0 +1,40 @@
+package darwin
+
+import "time"
+
+// Stats are counters kept by the native SMC layer across every connection in
+// the process since it started.
+type Stats struct {
+	// Calls is the number of IOKit calls made to the SMC.
+	Calls uint64
+
+	// KeyNotFound is the number of times the SMC answered that a key does
+	// not exist, and MissingCached the number of reads of such keys that
+	// were answered without asking the SMC again.
+	KeyNotFound   uint64
+	MissingCached uint64
+
+	// Reconnects is the number of times a lost connection was re-opened.
+	Reconnects uint64
+
+	// DecodeFailures is the number of values read whose data type could not
+	// be decoded.
+	DecodeFailures uint64
+
+	CallLatency      Histogram
+	ReconnectLatency Histogram
+}
+
+// Histogram counts durations in power-of-two buckets. Buckets[i] holds the
+// durations below BucketBound(i) that did not fit an earlier bucket; the last
+// bucket also holds everything longer.
+type Histogram struct {
+	Count   uint64
+	Sum     time.Duration
+	Buckets []uint64
+}
+
+// BucketBound returns the exclusive upper bound of bucket i.
+func BucketBound(i int) time.Duration {
+	return time.Duration(uint64(1) << uint(i+1))
+}
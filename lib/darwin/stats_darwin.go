@@ -0,0 +1,36 @@
+// +build darwin,cgo
+
+package darwin
+
+// #include "smc.h"
+import "C"
+
+import "time"
+
+// ReadStats returns the current counters of the native SMC layer.
+func ReadStats() (*Stats, error) {
+	var s C.smc_stats_t
+	C.smc_get_stats(&s)
+
+	return &Stats{
+		Calls:            uint64(s.calls),
+		KeyNotFound:      uint64(s.key_not_found),
+		MissingCached:    uint64(s.missing_cached),
+		Reconnects:       uint64(s.reconnects),
+		DecodeFailures:   uint64(s.decode_failures),
+		CallLatency:      convertHistogram(&s.call_latency),
+		ReconnectLatency: convertHistogram(&s.reconnect_latency),
+	}, nil
+}
+
+func convertHistogram(h *C.smc_histogram_t) Histogram {
+	buckets := make([]uint64, len(h.buckets))
+	for i, n := range h.buckets {
+		buckets[i] = uint64(n)
+	}
+	return Histogram{
+		Count:   uint64(h.count),
+		Sum:     time.Duration(h.sum_ns),
+		Buckets: buckets,
+	}
+}
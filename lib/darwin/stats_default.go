@@ -0,0 +1,8 @@
+// +build !darwin !cgo
+
+package darwin
+
+// ReadStats returns ErrNotSupported on this platform.
+func ReadStats() (*Stats, error) {
+	return nil, ErrNotSupported
+}
@@ -0,0 +1,93 @@
+// smc_decode_fuzz is a libFuzzer target for the SMC type decoder. Each input
+// is a key's reply as read_key leaves it in an smc_return_t: a data type and
+// a data size as the SMC reported them, followed by the data bytes. The
+// decoder must accept exactly the sizes of the types it knows, read no byte
+// past the size and produce values within the range of the type. See the
+// fuzz-darwin-decode target of the GNUmakefile.
+//
+// An input starts with the four characters of the data type and a byte of
+// data size; smc_decode.dict holds the known types.
+
+#include "smc.c"
+
+#include <math.h>
+
+// fixed_range stores the smallest and largest values of a fixed point type.
+static void fixed_range(const smc_decoder_t *decoder, double *min,
+                        double *max) {
+  double scale = (double)(1u << decoder->frac_bits);
+  double span = ldexp(1.0, (int)decoder->data_size * 8);
+
+  if (decoder->kind == DECODE_SIGNED_FIXED) {
+    *min = -span / 2 / scale;
+    *max = (span / 2 - 1) / scale;
+  } else {
+    *min = 0;
+    *max = (span - 1) / scale;
+  }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  const smc_decoder_t *decoder;
+  smc_return_t result;
+  uint8_t *bytes;
+  double value, again, min, max;
+  int decoded, fractional;
+
+  if (size < 5) {
+    return 0;
+  }
+
+  // The SMC may answer with any type and size, and a size larger than the
+  // data it returns.
+  memset(&result, 0, sizeof(result));
+  result.data_type = (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 |
+                     (uint32_t)data[2] << 8 | (uint32_t)data[3];
+  result.data_size = data[4];
+  data += 5;
+  size -= 5;
+  memcpy(result.data, data,
+         size < sizeof(result.data) ? size : sizeof(result.data));
+
+  decoder = find_decoder(result.data_type);
+  decoded = smc_decode(result.data_type, result.data_size, result.data,
+                       &value) == 0;
+  if (decoded != (decoder != NULL && decoder->data_size == result.data_size)) {
+    abort();
+  }
+
+  // Only fractional types are taken to be sensor readings.
+  fractional = decoder != NULL &&
+               (decoder->kind == DECODE_FLOAT || decoder->frac_bits > 0);
+  if ((smc_sensor_kind(SMC_KEY('T', 'C', '0', 'P'), result.data_type) != 0) !=
+      fractional) {
+    abort();
+  }
+
+  if (!decoded) {
+    return 0;
+  }
+
+  // Decode a copy holding only data_size bytes, so that the sanitizer
+  // catches any read past them, and so that the bytes after them cannot have
+  // changed the value.
+  bytes = malloc(result.data_size);
+  if (bytes == NULL) {
+    return 0;
+  }
+  memcpy(bytes, result.data, result.data_size);
+  if (smc_decode(result.data_type, result.data_size, bytes, &again) != 0 ||
+      memcmp(&value, &again, sizeof(value)) != 0) {
+    abort();
+  }
+  free(bytes);
+
+  if (decoder->kind != DECODE_FLOAT) {
+    fixed_range(decoder, &min, &max);
+    if (!isfinite(value) || value < min || value > max) {
+      abort();
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,236 @@
+// smc_stress reads the SMC from many threads at once, each through its own
+// handle, with the keys the host has interleaved with keys it lacks, and
+// drops every handle's connection periodically so that reads keep going
+// through the reconnect path. It fails if threads disagree on the status of a
+// key, if a batch fails outright, if a dropped connection is not re-opened or
+// if the read rate falls below -m. It is meant to be built with
+// -fsanitize=thread; see the test-darwin-native target of the GNUmakefile.
+//
+// usage: smc_stress [-t threads] [-d seconds] [-r batches] [-m reads/s]
+
+#include "smc.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_KEYS 128
+#define MISSING_KEYS 8
+#define MAX_THREADS 256
+
+typedef struct {
+  smc_key_t keys[MAX_KEYS];
+  int count;
+
+  // status holds the first status read for each key, plus one so that 0
+  // means no thread has read it yet.
+  _Atomic int status[MAX_KEYS];
+
+  int reconnect_every; // batches between dropped connections, 0 for never.
+
+  _Atomic int stop;
+  _Atomic int failures;
+  _Atomic uint64_t reads;
+  _Atomic uint64_t drops;
+} stress_t;
+
+static void fail(stress_t *s, const char *format, ...) {
+  va_list args;
+
+  fflush(stdout);
+  va_start(args, format);
+  fprintf(stderr, "FAIL: ");
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+
+  atomic_fetch_add(&s->failures, 1);
+}
+
+static void key_name(smc_key_t key, char name[5]) {
+  for (int c = 0; c < 4; c++) {
+    name[c] = (char)(key >> (8 * (3 - c)));
+  }
+  name[4] = '\0';
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// check_reading verifies that keys[i] read with the same status as it did in
+// every other thread, and that failed reads left no stale value behind.
+static void check_reading(stress_t *s, int i, uint8_t status, double value) {
+  char name[5];
+  int expected = 0;
+
+  if (!atomic_compare_exchange_strong(&s->status[i], &expected, status + 1) &&
+      expected != status + 1) {
+    key_name(s->keys[i], name);
+    fail(s, "key %s read with status %d, previously %d", name, status,
+         expected - 1);
+  }
+
+  if (status != SMC_OK && value != 0.0) {
+    key_name(s->keys[i], name);
+    fail(s, "key %s failed with status %d but read %f", name, status, value);
+  }
+}
+
+static void *reader(void *arg) {
+  stress_t *s = arg;
+  smc_handle_t *handle;
+  smc_stats_t stats;
+  smc_error_t err;
+  double values[MAX_KEYS];
+  uint8_t statuses[MAX_KEYS];
+  uint64_t batches = 0;
+
+  if (open_smc(&handle) != SMC_OK) {
+    fail(s, "failed to open handle");
+    return NULL;
+  }
+
+  while (!atomic_load(&s->stop) && atomic_load(&s->failures) == 0) {
+    batches++;
+    if (s->reconnect_every > 0 && batches % s->reconnect_every == 0) {
+      smc_drop_connection(handle);
+      atomic_fetch_add(&s->drops, 1);
+    }
+
+    err = read_smc_many(handle, s->keys, values, statuses, s->count);
+    if (err != SMC_OK) {
+      fail(s, "batch failed with error %d", err);
+      break;
+    }
+    for (int i = 0; i < s->count; i++) {
+      check_reading(s, i, statuses[i], values[i]);
+    }
+    atomic_fetch_add_explicit(&s->reads, (uint64_t)s->count,
+                              memory_order_relaxed);
+
+    // Exercise the process-wide state that every handle shares as well.
+    if (batches % 64 == 0) {
+      smc_get_stats(&stats);
+      smc_backend();
+    }
+  }
+
+  close_smc(handle);
+  return NULL;
+}
+
+// add_keys fills s with the sensors the host has, plus #KEY so that every
+// batch makes at least one IOKit call, interleaved with keys no SMC has.
+static int add_keys(stress_t *s) {
+  smc_sensor_t sensors[MAX_KEYS];
+  smc_handle_t *handle;
+  int found = 0, missing = 0;
+
+  if (open_smc(&handle) != SMC_OK) {
+    return -1;
+  }
+  if (smc_discover_sensors(handle, SMC_SENSOR_ALL, sensors,
+                           MAX_KEYS - MISSING_KEYS - 1, &found) != SMC_OK) {
+    close_smc(handle);
+    return -1;
+  }
+  close_smc(handle);
+
+  s->keys[s->count++] = SMC_KEY('#', 'K', 'E', 'Y');
+  for (int i = 0; i < found; i++) {
+    if (missing < MISSING_KEYS && i % (found / MISSING_KEYS + 1) == 0) {
+      s->keys[s->count++] = SMC_KEY('z', 'z', 'z', '0' + missing++);
+    }
+    s->keys[s->count++] = sensors[i].key;
+  }
+  while (missing < MISSING_KEYS) {
+    s->keys[s->count++] = SMC_KEY('z', 'z', 'z', '0' + missing++);
+  }
+  return found;
+}
+
+int main(int argc, char **argv) {
+  static stress_t s;
+  pthread_t threads[MAX_THREADS];
+  smc_stats_t before, after;
+  int nthreads = 8, seconds = 5, opt, found;
+  double min_rate = 0, rate, elapsed;
+  uint64_t start;
+
+  s.reconnect_every = 100;
+  while ((opt = getopt(argc, argv, "t:d:r:m:")) != -1) {
+    switch (opt) {
+    case 't':
+      nthreads = atoi(optarg);
+      break;
+    case 'd':
+      seconds = atoi(optarg);
+      break;
+    case 'r':
+      s.reconnect_every = atoi(optarg);
+      break;
+    case 'm':
+      min_rate = atof(optarg);
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [-t threads] [-d seconds] [-r batches] [-m reads/s]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (nthreads < 1 || nthreads > MAX_THREADS || seconds < 1 ||
+      s.reconnect_every < 0) {
+    fprintf(stderr, "invalid arguments\n");
+    return 2;
+  }
+
+  if ((found = add_keys(&s)) < 0) {
+    fprintf(stderr, "failed to discover sensors\n");
+    return 1;
+  }
+  printf("reading %d keys (%d sensors) from %d threads for %ds\n", s.count,
+         found, nthreads, seconds);
+
+  smc_get_stats(&before);
+  start = now_ns();
+  for (int i = 0; i < nthreads; i++) {
+    pthread_create(&threads[i], NULL, reader, &s);
+  }
+  sleep((unsigned)seconds);
+  atomic_store(&s.stop, 1);
+  for (int i = 0; i < nthreads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  elapsed = (double)(now_ns() - start) / 1e9;
+  smc_get_stats(&after);
+
+  rate = (double)atomic_load(&s.reads) / elapsed;
+  printf("%.0f reads/s, %.0f IOKit calls/s, %llu reconnects for %llu drops\n",
+         rate, (double)(after.calls - before.calls) / elapsed,
+         (unsigned long long)(after.reconnects - before.reconnects),
+         (unsigned long long)atomic_load(&s.drops));
+
+  // Every drop is followed by a batch, whose #KEY read finds the connection
+  // lost.
+  if (after.reconnects - before.reconnects < atomic_load(&s.drops)) {
+    fail(&s, "%llu connections were dropped but only %llu re-opened",
+         (unsigned long long)atomic_load(&s.drops),
+         (unsigned long long)(after.reconnects - before.reconnects));
+  }
+  if (rate < min_rate) {
+    fail(&s, "read rate %.0f/s is below the minimum of %.0f/s", rate,
+         min_rate);
+  }
+
+  return atomic_load(&s.failures) == 0 ? 0 : 1;
+}
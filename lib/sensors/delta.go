@@ -0,0 +1,53 @@
+package sensors
+
+import (
+	"math"
+	"time"
+)
+
+// DeltaFilter remembers the readings last reported for a fixed set of
+// sensors so that only readings that have moved are reported again. Sensor
+// values barely change between samples, so this cuts most of the work and
+// metrics volume of forwarding every reading every interval.
+type DeltaFilter struct {
+	// Epsilon is how far a reading must move from the value last reported
+	// for it to be reported again.
+	Epsilon float64
+
+	// Refresh, if set, is how long a reading may go unreported before it is
+	// reported again anyway, e.g. so that metrics sinks do not expire it.
+	Refresh time.Duration
+
+	last     []float64
+	reported []time.Time // zero when the sensor has no reported value.
+}
+
+// Changed appends to dst the indexes of the readings that should be reported
+// at now and returns the extended slice. A reading is reported when it moved
+// by more than Epsilon since it was last reported, when its sensor could not
+// be read last time, or when it is due for a refresh. Readings of sensors that
+// could not be read are never reported.
+func (f *DeltaFilter) Changed(dst []int, values []float64, ok []bool, now time.Time) []int {
+	if len(f.last) != len(values) {
+		f.last = make([]float64, len(values))
+		f.reported = make([]time.Time, len(values))
+	}
+
+	for i, value := range values {
+		if !ok[i] {
+			f.reported[i] = time.Time{}
+			continue
+		}
+
+		if !f.reported[i].IsZero() &&
+			math.Abs(value-f.last[i]) <= f.Epsilon &&
+			(f.Refresh == 0 || now.Sub(f.reported[i]) < f.Refresh) {
+			continue
+		}
+
+		f.last[i] = value
+		f.reported[i] = now
+		dst = append(dst, i)
+	}
+	return dst
+}
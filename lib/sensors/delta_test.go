@@ -0,0 +1,45 @@
+package sensors
+
+import (
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/require"
+)
+
+func TestDeltaFilter_Changed(t *testing.T) {
+	f := &DeltaFilter{Epsilon: 0.5, Refresh: time.Minute}
+	now := time.Now()
+
+	// Every readable sensor is reported the first time.
+	changed := f.Changed(nil, []float64{50, 60, 0}, []bool{true, true, false}, now)
+	require.Equal(t, []int{0, 1}, changed)
+
+	// Movements within epsilon of the last reported value are dropped, even
+	// when they add up across samples.
+	now = now.Add(time.Second)
+	changed = f.Changed(changed[:0], []float64{50.4, 60.6, 0}, []bool{true, true, false}, now)
+	require.Equal(t, []int{1}, changed)
+
+	now = now.Add(time.Second)
+	changed = f.Changed(changed[:0], []float64{50.5, 60.6, 0}, []bool{true, true, false}, now)
+	require.Empty(t, changed)
+
+	now = now.Add(time.Second)
+	changed = f.Changed(changed[:0], []float64{50.6, 60.6, 0}, []bool{true, true, false}, now)
+	require.Equal(t, []int{0}, changed)
+
+	// A sensor that recovers from a failed read is reported again.
+	now = now.Add(time.Second)
+	changed = f.Changed(changed[:0], []float64{0, 60.6, 30}, []bool{false, true, true}, now)
+	require.Equal(t, []int{2}, changed)
+
+	now = now.Add(time.Second)
+	changed = f.Changed(changed[:0], []float64{50.6, 60.6, 30}, []bool{true, true, true}, now)
+	require.Equal(t, []int{0}, changed)
+
+	// Unchanged readings are refreshed once they go unreported long enough.
+	now = now.Add(time.Minute)
+	changed = f.Changed(changed[:0], []float64{50.6, 60.6, 30}, []bool{true, true, true}, now)
+	require.Equal(t, []int{0, 1, 2}, changed)
+}
@@ -0,0 +1,201 @@
+package sensors
+
+import (
+	"bytes"
+	"io"
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// hwmonTypes are the hwmon sensor types read, with the factor converting
+// their value into the unit of their kind; see the kernel's
+// Documentation/hwmon/sysfs-interface.rst.
+var hwmonTypes = map[string]struct {
+	kind  Kind
+	scale float64
+}{
+	"temp":  {KindTemperature, 1e-3}, // millidegrees Celsius
+	"fan":   {KindFan, 1},            // RPM
+	"power": {KindPower, 1e-6},       // microwatts
+	"in":    {KindVoltage, 1e-3},     // millivolts
+}
+
+// hwmonReader reads the sensors of every hwmon device. The input file of
+// each sensor is opened once and read with pread at offset 0, which has sysfs
+// produce a fresh value, so a read costs a single system call per sensor and
+// no path lookups.
+type hwmonReader struct {
+	sensors []Sensor
+	files   []*os.File
+	scales  []float64
+	buf     [32]byte
+}
+
+// hwmonSensor is a sensor found while walking the hwmon devices.
+type hwmonSensor struct {
+	sensor Sensor
+	path   string
+	scale  float64
+
+	// device and index order the sensors of each kind by device, then by
+	// the number of the sensor within it.
+	device int
+	index  int
+}
+
+func openHwmon(root string) (Reader, error) {
+	devices, err := ioutil.ReadDir(root)
+	if os.IsNotExist(err) {
+		return nil, ErrNotSupported
+	}
+	if err != nil {
+		return nil, err
+	}
+
+	var found []hwmonSensor
+	names := make(map[string]struct{})
+	for device, info := range devices {
+		dir := filepath.Join(root, info.Name())
+
+		// Older drivers keep their attributes in the device directory.
+		if _, err := os.Stat(filepath.Join(dir, "name")); err != nil {
+			dir = filepath.Join(dir, "device")
+		}
+		chip := readHwmonAttribute(filepath.Join(dir, "name"))
+		if chip == "" {
+			chip = info.Name()
+		}
+
+		inputs, _ := filepath.Glob(filepath.Join(dir, "*_input"))
+		for _, input := range inputs {
+			sensor, ok := parseHwmonInput(filepath.Base(input))
+			if !ok {
+				continue
+			}
+			typ := hwmonTypes[sensor.typ]
+
+			label := readHwmonAttribute(filepath.Join(dir, sensor.name+"_label"))
+			if label == "" {
+				label = sensor.name
+			}
+
+			// Identical chips, such as several drives, are told apart by
+			// their hwmon device.
+			name := chip + "/" + label
+			if _, ok := names[name]; ok {
+				name = info.Name() + "/" + label
+			}
+			names[name] = struct{}{}
+
+			found = append(found, hwmonSensor{
+				sensor: Sensor{Name: name, Kind: typ.kind},
+				path:   input,
+				scale:  typ.scale,
+				device: device,
+				index:  sensor.index,
+			})
+		}
+	}
+
+	sort.SliceStable(found, func(i, j int) bool {
+		a, b := found[i], found[j]
+		if a.sensor.Kind != b.sensor.Kind {
+			return a.sensor.Kind < b.sensor.Kind
+		}
+		if a.device != b.device {
+			return a.device < b.device
+		}
+		return a.index < b.index
+	})
+
+	r := &hwmonReader{
+		sensors: make([]Sensor, 0, len(found)),
+		files:   make([]*os.File, 0, len(found)),
+		scales:  make([]float64, 0, len(found)),
+	}
+	for _, sensor := range found {
+		f, err := os.Open(sensor.path)
+		if err != nil {
+			// The sensor may be restricted to root; skip it rather than
+			// fail every other one.
+			continue
+		}
+		r.sensors = append(r.sensors, sensor.sensor)
+		r.files = append(r.files, f)
+		r.scales = append(r.scales, sensor.scale)
+	}
+	return r, nil
+}
+
+// hwmonInput is the parsed name of a hwmon input file, e.g. "temp1_input".
+type hwmonInput struct {
+	typ   string // "temp"
+	name  string // "temp1"
+	index int    // 1
+}
+
+func parseHwmonInput(file string) (hwmonInput, bool) {
+	name := strings.TrimSuffix(file, "_input")
+	digits := strings.IndexAny(name, "0123456789")
+	if digits <= 0 {
+		return hwmonInput{}, false
+	}
+
+	typ := name[:digits]
+	if _, ok := hwmonTypes[typ]; !ok {
+		return hwmonInput{}, false
+	}
+	index, err := strconv.Atoi(name[digits:])
+	if err != nil {
+		return hwmonInput{}, false
+	}
+	return hwmonInput{typ: typ, name: name, index: index}, true
+}
+
+// readHwmonAttribute returns the trimmed contents of a hwmon attribute, or ""
+// if it cannot be read.
+func readHwmonAttribute(path string) string {
+	data, err := ioutil.ReadFile(path)
+	if err != nil {
+		return ""
+	}
+	return strings.TrimSpace(string(data))
+}
+
+func (r *hwmonReader) Sensors() []Sensor {
+	return r.sensors
+}
+
+func (r *hwmonReader) Read(values []float64, ok []bool) error {
+	for i, f := range r.files {
+		values[i], ok[i] = 0, false
+
+		// Drivers fail reads of sensors that are not ready or not
+		// connected, e.g. with EIO or ENODATA; those are just missing.
+		n, err := f.ReadAt(r.buf[:], 0)
+		if err != nil && err != io.EOF || n == 0 {
+			continue
+		}
+		value, err := strconv.ParseInt(string(bytes.TrimSpace(r.buf[:n])), 10, 64)
+		if err != nil {
+			continue
+		}
+		values[i], ok[i] = float64(value)*r.scales[i], true
+	}
+	return nil
+}
+
+func (r *hwmonReader) Close() error {
+	var first error
+	for _, f := range r.files {
+		if err := f.Close(); err != nil && first == nil {
+			first = err
+		}
+	}
+	r.files = nil
+	return first
+}
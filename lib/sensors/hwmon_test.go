@@ -0,0 +1,78 @@
+package sensors
+
+import (
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/stretchr/testify/require"
+)
+
+// writeHwmon creates the given attribute files of a fake hwmon device.
+func writeHwmon(t *testing.T, dir string, attributes map[string]string) {
+	require.NoError(t, os.MkdirAll(dir, 0755))
+	for name, value := range attributes {
+		require.NoError(t, ioutil.WriteFile(filepath.Join(dir, name), []byte(value+"\n"), 0644))
+	}
+}
+
+func TestHwmon(t *testing.T) {
+	root, err := ioutil.TempDir("", "hwmon")
+	require.NoError(t, err)
+	defer os.RemoveAll(root)
+
+	writeHwmon(t, filepath.Join(root, "hwmon0"), map[string]string{
+		"name":         "coretemp",
+		"temp1_input":  "52000",
+		"temp1_label":  "Package id 0",
+		"temp10_input": "48500",
+		"temp2_input":  "250",
+		"temp2_label":  "Core 0",
+		"temp2_max":    "100000",
+	})
+	writeHwmon(t, filepath.Join(root, "hwmon1"), map[string]string{
+		"name":         "nct6775",
+		"fan1_input":   "1200",
+		"in0_input":    "1104",
+		"power1_input": "14500000",
+		"curr1_input":  "900",
+		"temp1_input":  "not a number",
+	})
+	// Older drivers keep their attributes under device/.
+	writeHwmon(t, filepath.Join(root, "hwmon2", "device"), map[string]string{
+		"name":        "nct6775",
+		"temp1_input": "30000",
+	})
+
+	r, err := openHwmon(root)
+	require.NoError(t, err)
+	defer r.Close()
+
+	require.Equal(t, []Sensor{
+		{Name: "coretemp/Package id 0", Kind: KindTemperature},
+		{Name: "coretemp/Core 0", Kind: KindTemperature},
+		{Name: "coretemp/temp10", Kind: KindTemperature},
+		{Name: "nct6775/temp1", Kind: KindTemperature},
+		{Name: "hwmon2/temp1", Kind: KindTemperature},
+		{Name: "nct6775/fan1", Kind: KindFan},
+		{Name: "nct6775/power1", Kind: KindPower},
+		{Name: "nct6775/in0", Kind: KindVoltage},
+	}, r.Sensors())
+
+	values := make([]float64, len(r.Sensors()))
+	ok := make([]bool, len(r.Sensors()))
+	require.NoError(t, r.Read(values, ok))
+	require.Equal(t, []bool{true, true, true, false, true, true, true, true}, ok)
+	require.Equal(t, []float64{52, 0.25, 48.5, 0, 30, 1200, 14.5, 1.104}, values)
+
+	// Reads see the latest value through the descriptors kept open.
+	require.NoError(t, ioutil.WriteFile(filepath.Join(root, "hwmon0", "temp1_input"), []byte("61000\n"), 0644))
+	require.NoError(t, r.Read(values, ok))
+	require.Equal(t, 61.0, values[0])
+}
+
+func TestHwmon_NotSupported(t *testing.T) {
+	_, err := openHwmon(filepath.Join(os.TempDir(), "no-such-hwmon"))
+	require.Equal(t, ErrNotSupported, err)
+}
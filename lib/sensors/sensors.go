@@ -0,0 +1,69 @@
+// Package sensors reads the hardware sensors of the host, such as
+// temperatures and fan speeds, through the native interface of each
+// platform: the SMC on macOS and hwmon on Linux.
+package sensors
+
+import (
+	"errors"
+	"fmt"
+)
+
+// ErrNotSupported is returned on platforms without a sensors backend.
+var ErrNotSupported = errors.New("sensors: not supported on this platform")
+
+// Kind is what a sensor measures.
+type Kind int
+
+const (
+	// KindTemperature sensors read in degrees Celsius.
+	KindTemperature Kind = iota + 1
+
+	// KindFan sensors read the speed of a fan in RPM.
+	KindFan
+
+	// KindPower sensors read in watts.
+	KindPower
+
+	// KindVoltage sensors read in volts.
+	KindVoltage
+)
+
+func (k Kind) String() string {
+	switch k {
+	case KindTemperature:
+		return "temperature"
+	case KindFan:
+		return "fan"
+	case KindPower:
+		return "power"
+	case KindVoltage:
+		return "voltage"
+	default:
+		return fmt.Sprintf("unknown(%d)", int(k))
+	}
+}
+
+// Sensor describes a hardware sensor of the host.
+type Sensor struct {
+	// Name identifies the sensor on the host, e.g. "TC0P" for an SMC key or
+	// "coretemp/Package id 0" for a hwmon sensor.
+	Name string
+
+	Kind Kind
+}
+
+// Reader reads a fixed set of sensors together, keeping whatever native
+// handles it needs open between reads. It is not safe for concurrent use.
+type Reader interface {
+	// Sensors returns the sensors read, ordered by kind with temperatures
+	// first.
+	Sensors() []Sensor
+
+	// Read reads every sensor into values and ok, which must be as long as
+	// Sensors and are indexed like it. A sensor that cannot be read has ok
+	// set to false; an error means none could be read.
+	Read(values []float64, ok []bool) error
+
+	// Close releases the native handles of the reader.
+	Close() error
+}
@@ -0,0 +1,8 @@
+// +build darwin
+
+package sensors
+
+// Open returns a Reader of every sensor the SMC exposes.
+func Open() (Reader, error) {
+	return openSMC()
+}
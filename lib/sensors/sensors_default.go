@@ -0,0 +1,8 @@
+// +build !darwin,!linux
+
+package sensors
+
+// Open returns ErrNotSupported on this platform.
+func Open() (Reader, error) {
+	return nil, ErrNotSupported
+}
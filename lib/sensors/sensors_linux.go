@@ -0,0 +1,11 @@
+// +build linux
+
+package sensors
+
+// hwmonRoot is where the kernel lists hwmon devices.
+const hwmonRoot = "/sys/class/hwmon"
+
+// Open returns a Reader of every hwmon sensor of the host.
+func Open() (Reader, error) {
+	return openHwmon(hwmonRoot)
+}
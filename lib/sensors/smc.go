@@ -0,0 +1,90 @@
+package sensors
+
+import "github.com/hashicorp/nomad/lib/darwin"
+
+// darwinKinds maps the kinds of SMC sensors, in the order readers report
+// them.
+var darwinKinds = []struct {
+	darwin darwin.SensorKind
+	kind   Kind
+}{
+	{darwin.KindTemperature, KindTemperature},
+	{darwin.KindFan, KindFan},
+	{darwin.KindPower, KindPower},
+	{darwin.KindVoltage, KindVoltage},
+}
+
+// OrderDarwin returns the SMC sensors ordered by kind, as a Reader orders
+// them, along with their descriptions. It lets the SMC sensors be read by
+// other means, such as the background sampler of package darwin, while being
+// reported like the sensors of any Reader.
+func OrderDarwin(discovered []darwin.Sensor) ([]darwin.Sensor, []Sensor) {
+	native := make([]darwin.Sensor, 0, len(discovered))
+	sensors := make([]Sensor, 0, len(discovered))
+	for _, kind := range darwinKinds {
+		for _, sensor := range darwin.FilterSensors(discovered, kind.darwin) {
+			native = append(native, sensor)
+			sensors = append(sensors, Sensor{Name: sensor.Key, Kind: kind.kind})
+		}
+	}
+	return native, sensors
+}
+
+// smcReader reads SMC sensors in batches through package darwin.
+type smcReader struct {
+	sensors []Sensor
+	smc     *darwin.SMC
+	batch   *darwin.Batch
+}
+
+func openSMC() (Reader, error) {
+	discovered, err := darwin.Sensors()
+	if err == darwin.ErrNotSupported {
+		return nil, ErrNotSupported
+	}
+	if err != nil {
+		return nil, err
+	}
+
+	native, sensors := OrderDarwin(discovered)
+	r := &smcReader{sensors: sensors}
+	if len(native) == 0 {
+		return r, nil
+	}
+
+	// The reader keeps its own connection so that it never contends with
+	// other readers of the SMC.
+	if r.smc, err = darwin.Open(); err != nil {
+		return nil, err
+	}
+	if r.batch, err = darwin.NewBatch(native); err != nil {
+		r.smc.Close()
+		return nil, err
+	}
+	return r, nil
+}
+
+func (r *smcReader) Sensors() []Sensor {
+	return r.sensors
+}
+
+func (r *smcReader) Read(values []float64, ok []bool) error {
+	if r.batch == nil {
+		return nil
+	}
+	if err := r.smc.ReadBatch(r.batch); err != nil {
+		return err
+	}
+	for i := range r.sensors {
+		values[i], ok[i] = r.batch.Value(i)
+	}
+	return nil
+}
+
+func (r *smcReader) Close() error {
+	if r.batch == nil {
+		return nil
+	}
+	r.batch.Free()
+	return r.smc.Close()
+}
@@ -1595,6 +1595,16 @@ const (
 	NodeEventSubsystemHeartbeat = "Heartbeat"
 	NodeEventSubsystemCluster   = "Cluster"
 	NodeEventSubsystemStorage   = "Storage"
+	NodeEventSubsystemSensors   = "Sensors"
+)
+
+const (
+	// NodeAttrThermalHeadroom is the node attribute in which clients that opt
+	// in report how far, in °C, the host is below its throttling temperature.
+	// The scheduler penalizes nodes with little headroom. It changes over
+	// time, so it is in the unique namespace to keep it out of the node's
+	// computed class.
+	NodeAttrThermalHeadroom = "unique.sensors.thermal.headroom"
 )
 
 // NodeEvent is a single unit representing a node’s state change
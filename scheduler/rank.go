@@ -3,6 +3,7 @@ package scheduler
 import (
 	"fmt"
 	"math"
+	"strconv"
 
 	"github.com/hashicorp/nomad/lib/cpuset"
 
@@ -13,6 +14,10 @@ const (
 	// binPackingMaxFitScore is the maximum possible bin packing fitness score.
 	// This is used to normalize bin packing score to a value between 0 and 1
 	binPackingMaxFitScore = 18.0
+
+	// thermalHeadroomThreshold is the headroom in °C below which nodes are
+	// penalized. The penalty grows linearly to -1 at no headroom.
+	thermalHeadroomThreshold = 20.0
 )
 
 // Rank is used to provide a score and various ranking metadata
@@ -645,6 +650,63 @@ func (iter *NodeReschedulingPenaltyIterator) Reset() {
 	iter.source.Reset()
 }
 
+// ThermalPenaltyIterator is used to apply a penalty to nodes that report
+// little thermal headroom, since work placed on a node that is about to
+// throttle runs slower than on a cooler one. Nodes that do not report their
+// headroom are not scored.
+type ThermalPenaltyIterator struct {
+	ctx    Context
+	source RankIterator
+}
+
+// NewThermalPenaltyIterator is used to create a ThermalPenaltyIterator that
+// penalizes placement onto hot nodes
+func NewThermalPenaltyIterator(ctx Context, source RankIterator) *ThermalPenaltyIterator {
+	return &ThermalPenaltyIterator{
+		ctx:    ctx,
+		source: source,
+	}
+}
+
+func (iter *ThermalPenaltyIterator) Next() *RankedNode {
+	option := iter.source.Next()
+	if option == nil {
+		return nil
+	}
+
+	attr, ok := option.Node.Attributes[structs.NodeAttrThermalHeadroom]
+	if !ok {
+		return option
+	}
+	headroom, err := strconv.ParseFloat(attr, 64)
+	if err != nil {
+		return option
+	}
+
+	score := thermalPenalty(headroom)
+	if score != 0 {
+		option.Scores = append(option.Scores, score)
+	}
+	iter.ctx.Metrics().ScoreNode(option.Node, "thermal-penalty", score)
+	return option
+}
+
+func (iter *ThermalPenaltyIterator) Reset() {
+	iter.source.Reset()
+}
+
+// thermalPenalty returns the score, between -1 and 0, for a node with the
+// given thermal headroom.
+func thermalPenalty(headroom float64) float64 {
+	if headroom >= thermalHeadroomThreshold {
+		return 0
+	}
+	if headroom <= 0 {
+		return -1
+	}
+	return -(thermalHeadroomThreshold - headroom) / thermalHeadroomThreshold
+}
+
 // NodeAffinityIterator is used to resolve any affinity rules in the job or task group,
 // and apply a weighted score to nodes if they match.
 type NodeAffinityIterator struct {
@@ -1741,6 +1741,38 @@ func TestNodeAntiAffinity_PenaltyNodes(t *testing.T) {
 
 }
 
+func TestThermalPenaltyIterator(t *testing.T) {
+	_, ctx := testContext(t)
+	hot := mock.Node()
+	hot.Attributes[structs.NodeAttrThermalHeadroom] = "5"
+	cool := mock.Node()
+	cool.Attributes[structs.NodeAttrThermalHeadroom] = "40"
+	unknown := mock.Node()
+
+	nodes := []*RankedNode{
+		{Node: hot},
+		{Node: cool},
+		{Node: unknown},
+	}
+	static := NewStaticRankIterator(ctx, nodes)
+
+	thermalIter := NewThermalPenaltyIterator(ctx, static)
+	scoreNorm := NewScoreNormalizationIterator(ctx, thermalIter)
+
+	out := collectRanked(scoreNorm)
+
+	require := require.New(t)
+	require.Equal(3, len(out))
+	require.Equal(hot.ID, out[0].Node.ID)
+	require.Equal(-0.75, out[0].FinalScore)
+
+	require.Equal(cool.ID, out[1].Node.ID)
+	require.Equal(0.0, out[1].FinalScore)
+
+	require.Equal(unknown.ID, out[2].Node.ID)
+	require.Equal(0.0, out[2].FinalScore)
+}
+
 func TestScoreNormalizationIterator(t *testing.T) {
 	// Test normalized scores when there is more than one scorer
 	_, ctx := testContext(t)